@@ -0,0 +1,89 @@
+/*
+ *  libgudevxx - a C++ wrapper for libgudev
+ *
+ *  Copyright (C) 2025  Daniel K. O.
+ *  SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+/*----------------------------------------------------------.
+| Compares the GObject backend (gudev::) with the direct     |
+| libudev backend (gudev::udev::).                           |
+|                                                            |
+| Each round enumerates all devices (or one subsystem) and   |
+| reads every property of every device.                      |
+|                                                            |
+| Usage:                                                     |
+|                                                            |
+|     ./backend-bench [rounds] [subsystem]                   |
+`-----------------------------------------------------------*/
+
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include <gudevxx/Client.hpp>
+#include <gudevxx/Enumerator.hpp>
+#include <gudevxx/udev/Client.hpp>
+#include <gudevxx/udev/Enumerator.hpp>
+
+using std::cout;
+using std::endl;
+using std::string;
+
+using clock_type = std::chrono::steady_clock;
+
+
+template<typename Client,
+         typename Enumerator>
+std::size_t
+run_round(Client& client,
+          const string& subsystem)
+{
+    Enumerator etor{client};
+    if (!subsystem.empty())
+        etor.match_subsystem(subsystem);
+    std::size_t total = 0;
+    for (auto& dev : etor.execute())
+        for (auto& key : dev.property_keys())
+            total += dev.property(key).value_or("").size();
+    return total;
+}
+
+
+template<typename Client,
+         typename Enumerator>
+void
+bench(const char* label,
+      unsigned rounds,
+      const string& subsystem)
+{
+    Client client;
+    std::size_t checksum = 0;
+    auto start = clock_type::now();
+    for (unsigned i = 0; i < rounds; ++i)
+        checksum += run_round<Client, Enumerator>(client, subsystem);
+    auto elapsed = std::chrono::duration<double, std::milli>(clock_type::now() - start);
+    cout << std::setw(8) << label
+         << " | " << std::setw(10) << std::fixed << std::setprecision(2)
+         << elapsed.count() / rounds << " ms/round"
+         << " | checksum " << checksum
+         << endl;
+}
+
+
+int
+main(int argc,
+     char* argv[])
+{
+    unsigned rounds = argc > 1 ? std::atoi(argv[1]) : 10;
+    string subsystem = argc > 2 ? argv[2] : "";
+    if (!rounds)
+        rounds = 1;
+
+    bench<gudev::Client, gudev::Enumerator>("gudev", rounds, subsystem);
+    bench<gudev::udev::Client, gudev::udev::Enumerator>("libudev", rounds, subsystem);
+}
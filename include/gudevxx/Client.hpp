@@ -12,20 +12,35 @@
 #include <cstdint>
 #include <filesystem>
 #include <functional>
+#include <limits>
 #include <memory>
+#include <memory_resource>
 #include <optional>
+#include <span>
 #include <string>
 #include <tuple>
+#include <utility>
 #include <vector>
 
 #include <gudev/gudev.h>
 
 #include "Device.hpp"
+#include "EventQueue.hpp"
 #include "GObjectWrapper.hpp"
+#include "Stats.hpp"
+#include "zstring_view.hpp"
 
 
 namespace gudev {
 
+    class MonitorHub;
+
+    namespace detail {
+        struct SeqnumTracker;
+        struct SubtreeWatches;
+    }
+
+
     class Client :
         public detail::GObjectWrapper<GUdevClient> {
 
@@ -43,6 +58,21 @@ namespace gudev {
         /// Listen events for subsystems
         Client(const std::vector<std::string>& subsystems);
 
+        /// Listen events for subsystems, without copying the filter strings.
+        Client(std::span<const zstring_view> subsystems);
+
+
+        struct shared_t {
+            explicit shared_t() = default;
+        };
+
+        /// Tag to receive events through the process-wide `MonitorHub`.
+        static constexpr shared_t shared{};
+
+        /// Listen events for subsystems (all if empty) through the shared monitor.
+        Client(shared_t,
+               const std::vector<std::string>& subsystems);
+
 
         void
         create();
@@ -50,12 +80,26 @@ namespace gudev {
         void
         create(const std::vector<std::string>& subsystems);
 
+        void
+        create(std::span<const zstring_view> subsystems);
+
+        void
+        create(shared_t,
+               const std::vector<std::string>& subsystems);
+
+        bool
+        is_shared()
+            const noexcept;
+
 
         void
         destroy()
             noexcept override;
 
 
+        ~Client()
+            noexcept;
+
         /// Move constructor.
         Client(Client&& other)
             noexcept;
@@ -66,14 +110,132 @@ namespace gudev {
             noexcept;
 
 
+        // stats
+
+        /// Start (or stop and discard) counting stats for this client.
+        void
+        enable_stats(bool enable = true);
+
+        bool
+        stats_enabled()
+            const noexcept;
+
+        /// Snapshot of this client's stats; all zeros if disabled.
+        Stats
+        stats()
+            const noexcept;
+
+        void
+        reset_stats()
+            noexcept;
+
+
+        // seqnum tracking
+
+        struct SeqnumStats {
+            std::optional<std::uint64_t> last_seqnum;
+            std::uint64_t gaps      = 0; ///< Confirmed gaps.
+            std::uint64_t dropped   = 0; ///< Events in confirmed gaps.
+            std::uint64_t reordered = 0; ///< Events that arrived after a later seqnum.
+            std::uint64_t resyncs   = 0;
+        };
+
+
+        /**
+         * Track the seqnums of received events, to detect events lost when the
+         * netlink receive buffer overflows.
+         *
+         * udev delivers events out of order, so a missing seqnum is only
+         * reported as a gap after `reorder_window` later events arrived. Only
+         * meaningful for clients without a subsystem filter: filtered out
+         * events leave holes in the sequence too.
+         */
+        void
+        enable_seqnum_tracking(bool enable = true,
+                               unsigned reorder_window = 32);
+
+        bool
+        seqnum_tracking_enabled()
+            const noexcept;
+
+        /**
+         * Keep a view of the devices in the client's subsystems, and resync
+         * it after every gap. Enables seqnum tracking if needed.
+         *
+         * Only the subsystems of the events received within the reorder
+         * window around the gap are re-enumerated, since lost events usually
+         * come from the same burst; call `resync()` to also catch losses in
+         * other subsystems. If no event was seen near the gap, the whole view
+         * is resynced.
+         *
+         * Gaps are only meaningful for an unfiltered, unshared client, so
+         * enabling it on a client with a subsystem filter, or on a shared
+         * client, throws `std::logic_error`; recreating the client with a
+         * filter turns it off.
+         */
+        void
+        set_auto_resync(bool enable = true);
+
+        SeqnumStats
+        seqnum_stats()
+            const noexcept;
+
+        /**
+         * Re-enumerate the client's subsystems, and deliver synthetic "add",
+         * "change" and "remove" events for the differences from the last known
+         * view; the first call only takes the view.
+         */
+        void
+        resync();
+
+        /// Like `resync()`, but only re-enumerate (and diff) these subsystems.
+        void
+        resync(std::span<const std::string> subsystems);
+
+
+        /// Called with the first and last missing seqnums of each gap.
+        std::function<void (std::uint64_t, std::uint64_t)> gap_callback;
+
+
+        // event queue
+
+        /**
+         * Queue events between dispatch and the handlers; they're delivered
+         * in batches from the default GLib main context, or by
+         * `process_events()`.
+         */
+        void
+        enable_event_queue(const EventQueue::Options& options = {});
+
+        /// Deliver the queued events, and stop queueing.
+        void
+        disable_event_queue();
+
+        EventQueue*
+        event_queue()
+            noexcept;
+
+        const EventQueue*
+        event_queue()
+            const noexcept;
+
+        /// Deliver up to `max` queued events; returns how many were delivered.
+        std::size_t
+        process_events(std::size_t max = std::numeric_limits<std::size_t>::max());
+
+
         // query operations
 
         std::vector<Device>
-        query(const std::string& subsystem = "");
+        query(zstring_view subsystem = {});
+
+        std::pmr::vector<Device>
+        query(zstring_view subsystem,
+              std::pmr::memory_resource* mr);
 
         std::optional<Device>
-        get(const std::string& subsystem,
-            const std::string& name);
+        get(zstring_view subsystem,
+            zstring_view name);
 
         std::optional<Device>
         get(GUdevDeviceType type,
@@ -86,10 +248,106 @@ namespace gudev {
         get_sysfs(const std::filesystem::path& sysfs_path);
 
 
+        // batched query operations
+
+        /*
+         * These resolve each distinct device only once, and return results in
+         * input order. Device files are resolved to device numbers first, so
+         * different links to the same device share a lookup. With
+         * `num_threads > 1`, lookups are split across threads, each with its
+         * own GUdevClient.
+         */
+
+        std::vector<std::optional<Device>>
+        get_many(std::span<const std::pair<GUdevDeviceType, GUdevDeviceNumber>> numbers,
+                 unsigned num_threads = 1);
+
+        std::vector<std::optional<Device>>
+        get_many(std::span<const std::filesystem::path> device_paths,
+                 unsigned num_threads = 1);
+
+        std::vector<std::optional<Device>>
+        get_sysfs_many(std::span<const std::filesystem::path> sysfs_paths,
+                       unsigned num_threads = 1);
+
+
         /// Callback for "uevent" signal.
         std::function<void (const std::string&, Device& device)> uevent_callback;
 
 
+        // subtree watches
+
+        using watch_id = std::uint64_t;
+
+        using subtree_callback = std::function<void (const std::string&, Device& device)>;
+
+        /**
+         * Call `callback` for events on the device at `sysfs_prefix`, and on
+         * every device below it.
+         *
+         * Prefixes match whole path components, so "/sys/devices/pci0000:00"
+         * does not match "/sys/devices/pci0000:000". Watches are kept in a
+         * radix trie, so routing an event costs time proportional to the
+         * depth of its sysfs path, regardless of how many watches exist.
+         * Watch callbacks run after `uevent_callback`, shallowest prefix
+         * first.
+         */
+        watch_id
+        watch_subtree(const std::filesystem::path& sysfs_prefix,
+                      subtree_callback callback);
+
+        /// Returns false if there's no such watch.
+        bool
+        unwatch_subtree(watch_id id);
+
+        std::size_t
+        num_subtree_watches()
+            const noexcept;
+
+
+        /**
+         * Subtree watch that is removed when this object is destroyed.
+         *
+         * Holds a reference to the `GUdevClient`, not to the `Client`, so it
+         * may outlive the client, and survives the client being moved.
+         */
+        class ScopedWatch {
+
+            GUdevClient* cli = nullptr;
+            watch_id id = 0;
+
+        public:
+
+            ScopedWatch()
+                noexcept = default;
+
+            ScopedWatch(Client& client,
+                        const std::filesystem::path& sysfs_prefix,
+                        subtree_callback callback);
+
+            ScopedWatch(ScopedWatch&& other)
+                noexcept;
+
+            ScopedWatch&
+            operator =(ScopedWatch&& other)
+                noexcept;
+
+            ~ScopedWatch()
+                noexcept;
+
+
+            /// Remove the watch, if any.
+            void
+            reset()
+                noexcept;
+
+            explicit
+            operator bool()
+                const noexcept;
+
+        }; // class ScopedWatch
+
+
         static
         Client*
         get_wrapper(GUdevClient* cli)
@@ -116,12 +374,64 @@ namespace gudev {
         on_uevent(const std::string& action,
                   Device& device);
 
+        /// Virtual method for seqnum gaps.
+        virtual
+        void
+        on_gap(std::uint64_t first,
+               std::uint64_t last);
+
     private:
 
+        friend class MonitorHub;
+
+        std::unique_ptr<detail::StatsCounters> stats_counters;
+        std::unique_ptr<detail::SeqnumTracker> seqnum_tracker;
+        std::unique_ptr<EventQueue> queue;
+        std::unique_ptr<detail::SubtreeWatches> subtree_watches;
+        guint queue_source = 0;
+        std::vector<std::string> subsystem_filter;
+        bool shared_monitor = false;
+
+
         // Inherit constructors.
         using BaseType::BaseType;
 
 
+        void
+        deliver_uevent(const std::string& action,
+                       Device& device);
+
+        /// Entry point for events, from the signal or from the hub; returns false on errors.
+        bool
+        receive_uevent(const char* act,
+                       GUdevDevice* dev)
+            noexcept;
+
+        /// Deliver or enqueue.
+        void
+        post_uevent(const std::string& action,
+                    Device& device);
+
+        EventQueue::handler_type
+        queue_handler();
+
+        void
+        track_uevent(const std::string& action,
+                     Device& device);
+
+        /// Resync the subsystems in `only`, or all if null.
+        void
+        resync_view(const std::span<const std::string>* only);
+
+        void
+        route_subtree(const std::string& action,
+                      Device& device);
+
+        void
+        record_batch(const std::vector<std::optional<Device>>& result)
+            noexcept;
+
+
         void
         connect_uevent_handler()
             noexcept;
@@ -131,6 +441,11 @@ namespace gudev {
             noexcept;
 
 
+        static
+        gboolean
+        dispatch_queue_idle(gpointer data)
+            noexcept;
+
         static
         void
         dispatch_uevent_signal(GUdevClient* cli,
@@ -14,6 +14,7 @@
 #include <cstdint>
 #include <filesystem>
 #include <iosfwd>
+#include <memory_resource>
 #include <optional>
 #include <string>
 #include <vector>
@@ -21,6 +22,8 @@
 #include <gudev/gudev.h>
 
 #include "GObjectWrapper.hpp"
+#include "strv_view.hpp"
+#include "zstring_view.hpp"
 
 
 namespace gudev {
@@ -106,25 +109,43 @@ namespace gudev {
         device_symlinks()
             const;
 
+        std::pmr::vector<std::pmr::string>
+        device_symlinks(std::pmr::memory_resource* mr)
+            const;
+
+        /// Non-owning view, valid while this device is alive.
+        strv_view
+        device_symlinks_view()
+            const noexcept;
+
         std::optional<Device>
         parent()
             const;
 
         std::optional<Device>
-        parent(const std::string& subsystem)
+        parent(zstring_view subsystem)
             const;
 
         std::optional<Device>
-        parent(const std::string& subsystem,
-               const std::string& devtype)
+        parent(zstring_view subsystem,
+               zstring_view devtype)
             const;
 
         std::vector<std::string>
         tags()
             const;
 
+        std::pmr::vector<std::pmr::string>
+        tags(std::pmr::memory_resource* mr)
+            const;
+
+        /// Non-owning view, valid while this device is alive.
+        strv_view
+        tags_view()
+            const noexcept;
+
         bool
-        has_tag(const std::string& tag)
+        has_tag(zstring_view tag)
             const;
 
         bool
@@ -139,22 +160,36 @@ namespace gudev {
         property_keys()
             const;
 
+        std::pmr::vector<std::pmr::string>
+        property_keys(std::pmr::memory_resource* mr)
+            const;
+
+        /// Non-owning view, valid while this device is alive.
+        strv_view
+        property_keys_view()
+            const noexcept;
+
         bool
-        has_property(const std::string& key)
+        has_property(zstring_view key)
             const;
 
         std::optional<std::string>
-        property(const std::string& key)
+        property(zstring_view key)
             const;
 
         // T = int, uint64_t, double, bool, string
         template<typename T>
         T
-        property_as(const std::string& key)
+        property_as(zstring_view key)
             const;
 
         std::vector<std::string>
-        property_tokens(const std::string& key)
+        property_tokens(zstring_view key)
+            const;
+
+        std::pmr::vector<std::pmr::string>
+        property_tokens(zstring_view key,
+                        std::pmr::memory_resource* mr)
             const;
 
 
@@ -162,22 +197,36 @@ namespace gudev {
         sysfs_attr_keys()
             const;
 
+        std::pmr::vector<std::pmr::string>
+        sysfs_attr_keys(std::pmr::memory_resource* mr)
+            const;
+
+        /// Non-owning view, valid while this device is alive.
+        strv_view
+        sysfs_attr_keys_view()
+            const noexcept;
+
         bool
-        has_sysfs_attr(const std::string& key)
+        has_sysfs_attr(zstring_view key)
             const;
 
         std::optional<std::string>
-        sysfs_attr(const std::string& key)
+        sysfs_attr(zstring_view key)
             const;
 
         // T = int, uint64_t, double, bool, string
         template<typename T>
         T
-        sysfs_attr_as(const std::string& key)
+        sysfs_attr_as(zstring_view key)
             const;
 
         std::vector<std::string>
-        sysfs_attr_tokens(const std::string& key)
+        sysfs_attr_tokens(zstring_view key)
+            const;
+
+        std::pmr::vector<std::pmr::string>
+        sysfs_attr_tokens(zstring_view key,
+                          std::pmr::memory_resource* mr)
             const;
 
 
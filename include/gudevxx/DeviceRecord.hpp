@@ -0,0 +1,71 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef LIBGUDEVXX_DEVICE_RECORD_HPP
+#define LIBGUDEVXX_DEVICE_RECORD_HPP
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Device.hpp"
+#include "zstring_view.hpp"
+
+
+namespace gudev {
+
+    /**
+     * Plain copy of the udev data of a device.
+     *
+     * Unlike `Device`, it holds no GObject, so it's safe to read from
+     * multiple threads.
+     */
+    struct DeviceRecord {
+
+        std::filesystem::path sysfs;
+        std::optional<std::string> subsystem;
+        std::optional<std::string> devtype;
+        std::optional<std::string> name;
+        std::optional<std::string> driver;
+        std::optional<std::filesystem::path> device_file;
+        std::optional<std::uint64_t> device_number;
+        std::optional<std::uint64_t> seqnum;
+        Device::Type type = Device::Type::no_device;
+        bool initialized = false;
+        std::map<std::string, std::string, std::less<>> properties;
+        std::vector<std::string> tags;
+        std::vector<std::filesystem::path> device_symlinks;
+
+
+        DeviceRecord() = default;
+
+        explicit
+        DeviceRecord(const Device& device);
+
+
+        bool
+        has_tag(std::string_view tag)
+            const noexcept;
+
+        bool
+        has_property(std::string_view key)
+            const;
+
+        std::optional<std::string>
+        property(std::string_view key)
+            const;
+
+    }; // struct DeviceRecord
+
+} // namespace gudev
+
+#endif
@@ -0,0 +1,172 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef LIBGUDEVXX_DEVICE_REGISTRY_HPP
+#define LIBGUDEVXX_DEVICE_REGISTRY_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Client.hpp"
+#include "Device.hpp"
+#include "DeviceRecord.hpp"
+#include "zstring_view.hpp"
+
+
+namespace gudev {
+
+    /**
+     * Device table for many reader threads and one writer thread.
+     *
+     * Readers see an immutable, versioned snapshot. Taking it is wait-free:
+     * a reader announces the current epoch in a per-thread slot, loads the
+     * published table and bumps its reference count, with no lock and no
+     * retry loop. The writer retires replaced tables and frees them once no
+     * reader announced an epoch old enough to see them.
+     *
+     * The table is split into shards by path hash, each shared between
+     * snapshots until modified; an update copies the shard array and the one
+     * shard holding the device, not the whole table.
+     *
+     * `attach()` connects it to a `Client`: it loads the table, then applies
+     * every event of the client, on the thread running the client's main
+     * context. Otherwise call `load()`, and feed each uevent to `update()`.
+     */
+    class DeviceRegistry {
+
+    public:
+
+        using record_ptr = std::shared_ptr<const DeviceRecord>;
+
+
+        struct Snapshot {
+
+            static constexpr std::size_t num_shards = 64;
+
+            using shard_type = std::map<std::filesystem::path, record_ptr>;
+            using shard_ptr = std::shared_ptr<const shard_type>;
+
+            std::uint64_t version = 0;
+            std::size_t count = 0;
+            /// Null shards are empty.
+            std::array<shard_ptr, num_shards> shards;
+
+
+            record_ptr
+            find(const std::filesystem::path& sysfs_path)
+                const;
+
+            std::size_t
+            size()
+                const noexcept;
+
+            /// Call `func(path, record)` for every device, in no particular order.
+            template<typename Func>
+            void
+            for_each(Func&& func)
+                const
+            {
+                for (auto& shard : shards)
+                    if (shard)
+                        for (auto& [path, rec] : *shard)
+                            func(path, rec);
+            }
+
+            static
+            std::size_t
+            shard_of(const std::filesystem::path& sysfs_path)
+                noexcept;
+
+        }; // struct Snapshot
+
+        using snapshot_ptr = std::shared_ptr<const Snapshot>;
+
+
+        DeviceRegistry();
+
+        ~DeviceRegistry()
+            noexcept;
+
+        DeviceRegistry(const DeviceRegistry&) = delete;
+
+
+        /// Get the current table; wait-free, safe to call from any thread.
+        snapshot_ptr
+        snapshot()
+            const;
+
+        /// Look up a device in the current table, without copying the snapshot pointer.
+        record_ptr
+        find(const std::filesystem::path& sysfs_path)
+            const;
+
+        std::uint64_t
+        version()
+            const;
+
+
+        /// Replace the table with the result of `client.query(subsystem)`.
+        void
+        load(Client& client,
+             zstring_view subsystem = {});
+
+        /// Apply a uevent and publish a new table; returns true if it changed.
+        bool
+        update(const std::string& action,
+               const Device& device);
+
+
+        /// Load from `client`, then apply its events until `detach()` or destruction.
+        void
+        attach(Client& client,
+               zstring_view subsystem = {});
+
+        void
+        detach()
+            noexcept;
+
+        bool
+        attached()
+            const noexcept;
+
+    private:
+
+        struct Holder;
+
+        std::atomic<const Holder*> current;
+        mutable std::mutex writer_mutex;
+        // Replaced tables, with the epoch they were retired in.
+        std::vector<std::pair<const Holder*, std::uint64_t>> retired;
+        Client::ScopedWatch watch;
+
+
+        void
+        publish(std::shared_ptr<const Snapshot> next);
+
+        void
+        reclaim()
+            noexcept;
+
+        template<typename Func>
+        auto
+        read(Func&& func)
+            const;
+
+    }; // class DeviceRegistry
+
+} // namespace gudev
+
+#endif
@@ -0,0 +1,242 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef LIBGUDEVXX_DEVICE_TABLE_HPP
+#define LIBGUDEVXX_DEVICE_TABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Device.hpp"
+
+
+namespace gudev {
+
+    /*
+     * Columns use the same buffer layouts as Apache Arrow: validity bitmaps
+     * are LSB-first with 1 meaning valid, strings are int32 offsets plus
+     * bytes, and dictionary columns are int32 indices into a string column.
+     */
+
+
+    struct Bitmap {
+
+        std::vector<std::uint8_t> bytes;
+        std::size_t length = 0;
+        std::size_t null_count = 0;
+
+
+        void
+        push(bool valid);
+
+        bool
+        operator [](std::size_t i)
+            const noexcept
+        {
+            return bytes[i / 8] & (1u << (i % 8));
+        }
+
+    }; // struct Bitmap
+
+
+    struct StringColumn {
+
+        std::vector<std::int32_t> offsets{0};
+        std::vector<char> data;
+        Bitmap validity;
+
+
+        void
+        push(std::optional<std::string_view> value);
+
+        std::size_t
+        size()
+            const noexcept
+        {
+            return validity.length;
+        }
+
+        std::optional<std::string_view>
+        operator [](std::size_t i)
+            const noexcept;
+
+    }; // struct StringColumn
+
+
+    struct DictionaryColumn {
+
+        std::vector<std::int32_t> indices;
+        Bitmap validity;
+        StringColumn dictionary;
+
+
+        std::size_t
+        size()
+            const noexcept
+        {
+            return validity.length;
+        }
+
+        std::optional<std::string_view>
+        operator [](std::size_t i)
+            const noexcept;
+
+    }; // struct DictionaryColumn
+
+
+    template<typename T>
+    struct NumericColumn {
+
+        std::vector<T> values;
+        Bitmap validity;
+
+
+        void
+        push(std::optional<T> value)
+        {
+            values.push_back(value.value_or(T{}));
+            validity.push(value.has_value());
+        }
+
+        std::size_t
+        size()
+            const noexcept
+        {
+            return validity.length;
+        }
+
+        std::optional<T>
+        operator [](std::size_t i)
+            const noexcept
+        {
+            if (!validity[i])
+                return {};
+            return values[i];
+        }
+
+    }; // struct NumericColumn
+
+
+    /// Devices in columnar form; one row per device.
+    struct DeviceTable {
+
+        std::size_t num_rows = 0;
+
+        StringColumn sysfs_path;
+        StringColumn device_file;
+        StringColumn name;
+        DictionaryColumn subsystem;
+        DictionaryColumn devtype;
+        DictionaryColumn driver;
+        NumericColumn<std::uint64_t> device_number;
+
+        /// One dictionary column per property key, in order of appearance.
+        std::vector<std::pair<std::string, DictionaryColumn>> properties;
+
+
+        const DictionaryColumn*
+        property(std::string_view key)
+            const noexcept;
+
+    }; // struct DeviceTable
+
+
+    /**
+     * Builds a `DeviceTable`, reading each device once.
+     *
+     * Without a list of property keys, a column is added for every key seen,
+     * with nulls for the earlier rows. Repeated keys in the list are ignored.
+     *
+     * If `append()` throws, the partial row is removed, so all columns keep
+     * the same length.
+     */
+    class DeviceTableBuilder {
+
+    public:
+
+        DeviceTableBuilder();
+
+        explicit
+        DeviceTableBuilder(std::span<const std::string> property_keys);
+
+
+        void
+        append(const Device& device);
+
+        void
+        append(std::span<const Device> devices);
+
+        std::size_t
+        size()
+            const noexcept;
+
+        /// Return the table, and reset the builder.
+        DeviceTable
+        finish();
+
+    private:
+
+        struct string_hash {
+
+            using is_transparent = void;
+
+            std::size_t
+            operator ()(std::string_view s)
+                const noexcept
+            {
+                return std::hash<std::string_view>{}(s);
+            }
+
+        };
+
+        using dict_map = std::unordered_map<std::string, std::int32_t, string_hash, std::equal_to<>>;
+
+        struct PropertyState {
+            dict_map lookup;
+            std::size_t last_row;
+        };
+
+        DeviceTable table;
+        bool discover_keys;
+        std::vector<std::string> fixed_keys;
+        dict_map subsystem_lookup;
+        dict_map devtype_lookup;
+        dict_map driver_lookup;
+        std::vector<PropertyState> property_states;
+        std::unordered_map<std::string, std::size_t, string_hash, std::equal_to<>> property_index;
+
+
+        static
+        void
+        push_dict(DictionaryColumn& column,
+                  dict_map& lookup,
+                  const char* value);
+
+        std::size_t
+        property_column(std::string_view key);
+
+        void
+        append_row(GUdevDevice* dev,
+                   const Device& device);
+
+        void
+        rollback(std::size_t num_properties)
+            noexcept;
+
+    }; // class DeviceTableBuilder
+
+} // namespace gudev
+
+#endif
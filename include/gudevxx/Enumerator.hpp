@@ -9,24 +9,54 @@
 #define LIBGUDEVXX_ENUMERATOR_HPP
 
 #include <cstddef>
+#include <exception>
 #include <filesystem>
+#include <functional>
+#include <memory_resource>
+#include <stop_token>
 #include <string>
 #include <vector>
 
+#include <gio/gio.h>
 #include <gudev/gudev.h>
 
 #include "Client.hpp"
 #include "GObjectWrapper.hpp"
+#include "MatchRules.hpp"
+#include "zstring_view.hpp"
 
 
 namespace gudev {
 
+    /// Options for `Enumerator::execute_async()`.
+    struct AsyncEnumerateOptions {
+        /// Maximum number of devices per chunk.
+        std::size_t chunk_size = 256;
+        /// Worker threads; 0 means `std::thread::hardware_concurrency()`.
+        unsigned num_threads = 1;
+    };
+
+
     struct Enumerator :
         detail::GObjectWrapper<GUdevEnumerator> {
 
         using BaseType = detail::GObjectWrapper<GUdevEnumerator>;
 
 
+        /// Receives each chunk of devices found by `execute_async()`.
+        using chunk_callback = std::function<void (std::vector<Device>&& chunk)>;
+
+        /**
+         * Called once when `execute_async()` finishes.
+         *
+         * `error` is set if the enumeration failed; `cancelled` is true if it
+         * was stopped early.
+         */
+        using done_callback = std::function<void (bool cancelled,
+                                                  std::exception_ptr error)>;
+
+
+
         Enumerator(std::nullptr_t = nullptr)
             noexcept;
 
@@ -48,28 +78,28 @@ namespace gudev {
 
 
         Enumerator&
-        match_subsystem(const std::string& subsystem);
+        match_subsystem(zstring_view subsystem);
 
         Enumerator&
-        nomatch_subsystem(const std::string& subsystem);
+        nomatch_subsystem(zstring_view subsystem);
 
         Enumerator&
-        match_sysfs_attr(const std::string& key,
-                         const std::string& val);
+        match_sysfs_attr(zstring_view key,
+                         zstring_view val);
 
         Enumerator&
-        nomatch_sysfs_attr(const std::string& key,
-                           const std::string& val);
+        nomatch_sysfs_attr(zstring_view key,
+                           zstring_view val);
 
         Enumerator&
-        match_property(const std::string& key,
-                       const std::string& val);
+        match_property(zstring_view key,
+                       zstring_view val);
 
         Enumerator&
-        match_name(const std::string& name);
+        match_name(zstring_view name);
 
         Enumerator&
-        match_tag(const std::string& tag);
+        match_tag(zstring_view tag);
 
         Enumerator&
         match_initialized();
@@ -81,6 +111,47 @@ namespace gudev {
         std::vector<Device>
         execute();
 
+        std::pmr::vector<Device>
+        execute(std::pmr::memory_resource* mr);
+
+
+        /**
+         * Enumerate on worker threads, delivering devices in chunks.
+         *
+         * The callbacks are invoked on the thread-default main context of the
+         * calling thread, so that thread must be running a main loop. The
+         * enumeration is partitioned by subsystem, like `ParallelEnumerator`,
+         * and each subsystem is delivered as soon as it's enumerated.
+         *
+         * Once `stop` is requested no more chunks are delivered, and
+         * `on_done` is called with `cancelled` set.
+         */
+        void
+        execute_async(chunk_callback on_chunk,
+                      done_callback on_done,
+                      std::stop_token stop = {},
+                      const AsyncEnumerateOptions& options = {})
+            const;
+
+        /// Same as above, cancelled through a `GCancellable`.
+        void
+        execute_async(chunk_callback on_chunk,
+                      done_callback on_done,
+                      GCancellable* cancellable,
+                      const AsyncEnumerateOptions& options = {})
+            const;
+
+
+        /// The rules added so far.
+        [[nodiscard]]
+        const MatchRules&
+        rules()
+            const noexcept;
+
+    private:
+
+        MatchRules recorded;
+
     };
 
 } // namespace gudev
@@ -0,0 +1,157 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef LIBGUDEVXX_EVENT_QUEUE_HPP
+#define LIBGUDEVXX_EVENT_QUEUE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <string>
+#include <unordered_map>
+
+#include "Device.hpp"
+
+
+namespace gudev {
+
+    /**
+     * Bounded queue of uevents, between `Client` dispatch and the user handlers.
+     *
+     * When the queue is full, the policy decides what happens, so overload
+     * is handled here instead of by the kernel silently dropping messages.
+     */
+    class EventQueue {
+
+    public:
+
+        enum class Policy {
+            /**
+             * Nothing actually blocks: when full, `push()` drains the queue
+             * down to the low watermark by running the handlers inline. For
+             * `Client`, that means the handlers are re-entered from within
+             * the dispatch of the overflowing uevent, and the socket isn't
+             * read meanwhile.
+             */
+            block,
+            drop_oldest,
+            drop_newest,
+            /// Merge events for the same device (always, not only when full); drop oldest when full.
+            coalesce
+        };
+
+
+        struct Options {
+            std::size_t capacity = 1024;
+            Policy policy = Policy::block;
+            /// 0 means 3/4 of capacity.
+            std::size_t high_watermark = 0;
+            /// 0 means 1/4 of capacity.
+            std::size_t low_watermark = 0;
+            /// Events delivered per main loop iteration.
+            std::size_t batch_size = 64;
+        };
+
+
+        struct Counters {
+            std::uint64_t enqueued  = 0;
+            std::uint64_t delivered = 0;
+            std::uint64_t dropped   = 0;
+            std::uint64_t coalesced = 0;
+            std::uint64_t blocked   = 0; ///< Times the block policy drained inline.
+            std::uint64_t high_watermark_hits = 0;
+            std::size_t max_depth = 0;
+        };
+
+
+        using handler_type = std::function<void (const std::string& action,
+                                                 Device& device)>;
+
+
+        EventQueue();
+
+        explicit
+        EventQueue(const Options& options);
+
+
+        /// Enqueue an event; `handler` is only used by the block policy.
+        void
+        push(const std::string& action,
+             Device& device,
+             const handler_type& handler);
+
+        /// Deliver up to `max` events; returns how many were delivered.
+        std::size_t
+        drain(const handler_type& handler,
+              std::size_t max = std::numeric_limits<std::size_t>::max());
+
+
+        std::size_t
+        size()
+            const noexcept;
+
+        bool
+        empty()
+            const noexcept;
+
+        const Options&
+        options()
+            const noexcept;
+
+        Counters
+        counters()
+            const noexcept;
+
+
+        /// Called when the size reaches the high watermark.
+        std::function<void (std::size_t size)> high_watermark_callback;
+
+        /// Called when the size falls back to the low watermark.
+        std::function<void (std::size_t size)> low_watermark_callback;
+
+    private:
+
+        struct Entry {
+            std::string action;
+            Device device;
+            std::string path;
+            bool valid = true;
+        };
+
+        Options opts;
+        Counters stats;
+        std::deque<Entry> entries;
+        // Absolute index of the first entry.
+        std::uint64_t base = 0;
+        std::size_t live = 0;
+        bool above_high = false;
+        // Sysfs path -> absolute index of its latest entry, for coalescing.
+        std::unordered_map<std::string, std::uint64_t> latest;
+
+
+        bool
+        coalesce(const std::string& action,
+                 Device& device,
+                 const std::string& path);
+
+        /// Remove the first entry, keeping `latest` consistent.
+        Entry
+        pop_front();
+
+        void
+        drop_oldest();
+
+        void
+        check_low_watermark();
+
+    }; // class EventQueue
+
+} // namespace gudev
+
+#endif
@@ -47,10 +47,10 @@ namespace gudev::detail {
             if (!this->is_valid())
                 return;
             gpointer ptr = g_object_get_data(G_OBJECT(this->raw), "cpp-wrapper");
+            // Note: with make_alias() several wrappers may share one object; only the
+            // registered one clears the data.
             if (this == reinterpret_cast<GObjectWrapper*>(ptr))
                 g_object_set_data(G_OBJECT(this->raw), "cpp-wrapper", nullptr);
-            else
-                g_warning("Unsetting wrapper in object %p that did not have it.", this->raw);
         }
 
 
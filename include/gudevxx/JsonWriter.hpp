@@ -0,0 +1,197 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef LIBGUDEVXX_JSON_WRITER_HPP
+#define LIBGUDEVXX_JSON_WRITER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "Device.hpp"
+#include "strv_view.hpp"
+
+
+namespace gudev {
+
+    struct Uevent;
+
+
+    /**
+     * Writes devices and uevents as NDJSON (one object per line) into a
+     * reusable buffer.
+     *
+     * Fields are selected at compile time. Strings are escaped, and invalid
+     * UTF-8 is replaced by U+FFFD. Call `clear()` after consuming `view()`,
+     * and the buffer's capacity is reused; or move the buffer in and out
+     * with the `std::string&&` constructor and `release()`, to avoid a copy.
+     */
+    class JsonWriter {
+
+    public:
+
+        enum Field : std::uint32_t {
+            subsystem     = 1u << 0,
+            devtype       = 1u << 1,
+            name          = 1u << 2,
+            number        = 1u << 3,
+            sysfs         = 1u << 4,
+            driver        = 1u << 5,
+            action        = 1u << 6,
+            seqnum        = 1u << 7,
+            device_number = 1u << 8,
+            device_file   = 1u << 9,
+            symlinks      = 1u << 10,
+            tags          = 1u << 11,
+            properties    = 1u << 12,
+            /// Reads every attribute from sysfs; not in `default_fields`.
+            sysfs_attrs   = 1u << 13,
+            initialized   = 1u << 14,
+
+            default_fields = ((1u << 13) - 1) | initialized,
+            all_fields     = (1u << 15) - 1
+        };
+
+
+        explicit
+        JsonWriter(std::size_t reserve = 64 * 1024);
+
+        /// Append to `buffer`, keeping its contents and capacity.
+        explicit
+        JsonWriter(std::string&& buffer)
+            noexcept;
+
+
+        template<std::uint32_t Fields = default_fields>
+        JsonWriter&
+        write(const Device& device);
+
+        /// All fields of the event, with properties as an object.
+        JsonWriter&
+        write(const Uevent& event);
+
+
+        std::string_view
+        view()
+            const noexcept;
+
+        std::size_t
+        size()
+            const noexcept;
+
+        void
+        clear()
+            noexcept;
+
+        /// Move the buffer out, leaving the writer empty.
+        std::string
+        release()
+            noexcept;
+
+        /// Write the buffer to a file descriptor, and clear it.
+        void
+        flush(int fd);
+
+
+        /// Append `str` as a quoted, escaped JSON string.
+        void
+        append_string(std::string_view str);
+
+    private:
+
+        std::string buf;
+        bool first_member = true;
+
+
+        void
+        begin_object();
+
+        void
+        end_object();
+
+        void
+        key(std::string_view k);
+
+        void
+        member(std::string_view k,
+               const char* value);
+
+        void
+        member(std::string_view k,
+               std::string_view value);
+
+        void
+        member(std::string_view k,
+               std::uint64_t value);
+
+        void
+        member(std::string_view k,
+               bool value);
+
+        void
+        member(std::string_view k,
+               strv_view values);
+
+        void
+        properties_member(GUdevDevice* dev,
+                          strv_view keys);
+
+        void
+        sysfs_attrs_member(GUdevDevice* dev,
+                           strv_view keys);
+
+    }; // class JsonWriter
+
+
+    template<std::uint32_t Fields>
+    JsonWriter&
+    JsonWriter::write(const Device& device)
+    {
+        GUdevDevice* dev = device.data();
+        begin_object();
+        if (dev) {
+            if constexpr (Fields & subsystem)
+                member("subsystem", g_udev_device_get_subsystem(dev));
+            if constexpr (Fields & devtype)
+                member("devtype", g_udev_device_get_devtype(dev));
+            if constexpr (Fields & name)
+                member("name", g_udev_device_get_name(dev));
+            if constexpr (Fields & number)
+                member("number", g_udev_device_get_number(dev));
+            if constexpr (Fields & sysfs)
+                member("sysfs", g_udev_device_get_sysfs_path(dev));
+            if constexpr (Fields & driver)
+                member("driver", g_udev_device_get_driver(dev));
+            if constexpr (Fields & action)
+                member("action", g_udev_device_get_action(dev));
+            if constexpr (Fields & seqnum)
+                if (auto s = g_udev_device_get_seqnum(dev))
+                    member("seqnum", std::uint64_t{s});
+            if constexpr (Fields & device_number)
+                if (g_udev_device_get_device_type(dev) != G_UDEV_DEVICE_TYPE_NONE)
+                    member("device_number", std::uint64_t{g_udev_device_get_device_number(dev)});
+            if constexpr (Fields & device_file)
+                member("device_file", g_udev_device_get_device_file(dev));
+            if constexpr (Fields & initialized)
+                member("initialized", bool(g_udev_device_get_is_initialized(dev)));
+            if constexpr (Fields & symlinks)
+                member("symlinks", device.device_symlinks_view());
+            if constexpr (Fields & tags)
+                member("tags", device.tags_view());
+            if constexpr (Fields & properties)
+                properties_member(dev, device.property_keys_view());
+            if constexpr (Fields & sysfs_attrs)
+                sysfs_attrs_member(dev, device.sysfs_attr_keys_view());
+        }
+        end_object();
+        return *this;
+    }
+
+} // namespace gudev
+
+#endif
@@ -0,0 +1,140 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef LIBGUDEVXX_LIVE_QUERY_HPP
+#define LIBGUDEVXX_LIVE_QUERY_HPP
+
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <string>
+
+#include "Client.hpp"
+#include "Device.hpp"
+#include "MatchRules.hpp"
+
+
+namespace gudev {
+
+    /**
+     * A query result that is kept up to date by uevents.
+     *
+     * The result is evaluated once through an `Enumerator` by `refresh()`;
+     * after that, each uevent passed to `update()` only re-evaluates the
+     * rules against the device in that event.
+     *
+     * `attach()` does both: it refreshes, then watches every event of the
+     * client. Otherwise, events must be passed to `update()` by hand, e.g.
+     * from the client's `uevent_callback`.
+     */
+    class LiveQuery {
+
+    public:
+
+        using map_type = std::map<std::filesystem::path, Device>;
+
+
+        explicit
+        LiveQuery(MatchRules rules);
+
+        /// Construct and `attach()` to `client`.
+        LiveQuery(MatchRules rules,
+                  Client& client);
+
+        LiveQuery(const LiveQuery&) = delete;
+
+        virtual
+        ~LiveQuery()
+            noexcept;
+
+
+        const MatchRules&
+        rules()
+            const noexcept;
+
+
+        /// Run a full enumeration and replace the current result, without callbacks.
+        void
+        refresh(Client& client);
+
+
+        /**
+         * Refresh from `client`, then apply each of its events, until
+         * `detach()` or destruction. The client must receive events for
+         * the subsystems in the rules.
+         */
+        void
+        attach(Client& client);
+
+        void
+        detach()
+            noexcept;
+
+        bool
+        attached()
+            const noexcept;
+
+
+        /// Apply a uevent; returns true if the result changed.
+        bool
+        update(const std::string& action,
+               Device& device);
+
+
+        const map_type&
+        devices()
+            const noexcept;
+
+        std::size_t
+        size()
+            const noexcept;
+
+        bool
+        contains(const std::filesystem::path& sysfs_path)
+            const;
+
+
+        /// Called after a device enters the result.
+        std::function<void (Device& device)> added_callback;
+
+        /// Called before a device leaves the result.
+        std::function<void (Device& device)> removed_callback;
+
+        /// Called after a device in the result is replaced by a newer event.
+        std::function<void (Device& device)> changed_callback;
+
+
+    protected:
+
+        virtual
+        void
+        on_added(Device& device);
+
+        virtual
+        void
+        on_removed(Device& device);
+
+        virtual
+        void
+        on_changed(Device& device);
+
+    private:
+
+        MatchRules match_rules;
+        map_type result;
+        Client::ScopedWatch watch;
+
+
+        bool
+        remove(const std::filesystem::path& sysfs_path);
+
+    }; // class LiveQuery
+
+} // namespace gudev
+
+#endif
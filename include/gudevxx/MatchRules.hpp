@@ -0,0 +1,90 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef LIBGUDEVXX_MATCH_RULES_HPP
+#define LIBGUDEVXX_MATCH_RULES_HPP
+
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Device.hpp"
+#include "zstring_view.hpp"
+
+
+namespace gudev {
+
+    struct Enumerator;
+
+
+    /**
+     * A set of match rules, with the same semantics as `Enumerator`.
+     *
+     * Unlike `Enumerator`, the rules can be evaluated against a single
+     * device, so they can be reused to filter uevents.
+     */
+    struct MatchRules {
+
+        std::vector<std::string> subsystems;
+        std::vector<std::string> nomatch_subsystems;
+        std::vector<std::pair<std::string, std::string>> sysfs_attrs;
+        std::vector<std::pair<std::string, std::string>> nomatch_sysfs_attrs;
+        std::vector<std::pair<std::string, std::string>> properties;
+        std::vector<std::string> names;
+        std::vector<std::string> tags;
+        bool initialized = false;
+        std::vector<std::filesystem::path> sysfs_paths;
+
+
+        MatchRules&
+        match_subsystem(zstring_view subsystem);
+
+        MatchRules&
+        nomatch_subsystem(zstring_view subsystem);
+
+        MatchRules&
+        match_sysfs_attr(zstring_view key,
+                         zstring_view val);
+
+        MatchRules&
+        nomatch_sysfs_attr(zstring_view key,
+                           zstring_view val);
+
+        MatchRules&
+        match_property(zstring_view key,
+                       zstring_view val);
+
+        MatchRules&
+        match_name(zstring_view name);
+
+        MatchRules&
+        match_tag(zstring_view tag);
+
+        MatchRules&
+        match_initialized();
+
+        MatchRules&
+        add_sysfs_path(const std::filesystem::path& sysfs_path);
+
+
+        /// Add all rules to an enumerator.
+        void
+        apply(Enumerator& etor)
+            const;
+
+
+        /// Check if a single device would be returned by an enumerator with these rules.
+        bool
+        matches(const Device& device)
+            const;
+
+    }; // struct MatchRules
+
+} // namespace gudev
+
+#endif
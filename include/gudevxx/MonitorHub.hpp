@@ -0,0 +1,134 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef LIBGUDEVXX_MONITOR_HUB_HPP
+#define LIBGUDEVXX_MONITOR_HUB_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <gudev/gudev.h>
+
+
+namespace gudev {
+
+    class Client;
+    class Device;
+
+
+    /**
+     * Process-wide monitor shared by every `Client` created with `Client::shared`.
+     *
+     * One netlink socket, filtered by the union of the registered subsystems,
+     * is read and parsed once, and each event is handed to the clients
+     * interested in its subsystem. The socket belongs to the main context
+     * of the thread that registered the first client.
+     *
+     * When a registration needs a subsystem the socket doesn't receive yet,
+     * the socket is reopened with the larger filter; events arriving during
+     * the switch may be lost.
+     */
+    class MonitorHub {
+
+    public:
+
+        struct Counters {
+            std::uint64_t events_received   = 0;
+            std::uint64_t events_dispatched = 0;
+            std::uint64_t sockets_opened    = 0;
+        };
+
+
+        static
+        MonitorHub&
+        instance();
+
+
+        MonitorHub(const MonitorHub&) = delete;
+
+        ~MonitorHub()
+            noexcept;
+
+
+        std::size_t
+        num_clients()
+            const;
+
+        /// Subsystem filter of the shared socket; empty if it receives everything.
+        std::vector<std::string>
+        filter()
+            const;
+
+        Counters
+        counters()
+            const;
+
+    private:
+
+        friend class Client;
+
+        // A subsystem filter entry, "subsystem" or "subsystem/devtype".
+        struct Target {
+            GUdevClient* client;
+            std::string devtype;
+        };
+
+        mutable std::mutex mutex;
+        std::map<GUdevClient*, std::vector<std::string>> registrations;
+        std::unordered_map<std::string, std::vector<Target>> by_subsystem;
+        std::vector<GUdevClient*> wildcard;
+        // Subsystems the socket receives; empty means all.
+        std::vector<std::string> socket_filter;
+        bool socket_unfiltered = false;
+        std::unique_ptr<Client> monitor;
+        // Closed monitors, freed from an idle source: they may be in the middle of a dispatch.
+        std::vector<std::unique_ptr<Client>> retired;
+        guint retired_source = 0;
+        Counters stats;
+
+
+        MonitorHub();
+
+        void
+        add(GUdevClient* client,
+            const std::vector<std::string>& subsystems);
+
+        void
+        remove(GUdevClient* client)
+            noexcept;
+
+
+        void
+        rebuild_index();
+
+        void
+        open_socket();
+
+        void
+        retire_monitor()
+            noexcept;
+
+        static
+        gboolean
+        free_retired(gpointer data)
+            noexcept;
+
+        void
+        dispatch(const std::string& action,
+                 Device& device);
+
+    }; // class MonitorHub
+
+} // namespace gudev
+
+#endif
@@ -0,0 +1,232 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef LIBGUDEVXX_NETLINK_MONITOR_HPP
+#define LIBGUDEVXX_NETLINK_MONITOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "basic_wrapper.hpp"
+
+
+namespace gudev {
+
+    /**
+     * A uevent parsed in place from a netlink message.
+     *
+     * All views point into the receive buffer, so they're only valid during the
+     * callback.
+     */
+    struct Uevent {
+
+        std::string_view action;
+        std::string_view devpath;
+        std::string_view subsystem;
+        std::string_view devtype;
+        std::uint64_t seqnum = 0;
+        bool from_kernel = false;
+
+        /// Null-separated "KEY=VALUE" list.
+        std::string_view properties;
+
+
+        std::optional<std::string_view>
+        property(std::string_view key)
+            const noexcept;
+
+        /// Call `func(key, value)` for every property.
+        void
+        for_each_property(const std::function<void (std::string_view,
+                                                    std::string_view)>& func)
+            const;
+
+        std::string
+        sysfs_path()
+            const;
+
+    }; // struct Uevent
+
+
+    /**
+     * Reads uevents directly from the netlink socket, many per system call.
+     *
+     * This is an alternative to the monitor inside `Client`: it doesn't create
+     * any `Device`, and parses messages in place. It can be driven by the
+     * GLib main loop (`attach()`), or by calling `receive()` when `fd()` is
+     * readable.
+     */
+    class NetlinkMonitor :
+        public detail::basic_wrapper<int, -1> {
+
+        using BaseType = detail::basic_wrapper<int, -1>;
+
+    public:
+
+        enum class Group : unsigned {
+            kernel = 1,
+            udev   = 2
+        };
+
+
+        struct Counters {
+            std::uint64_t messages  = 0;
+            std::uint64_t batches   = 0;
+            std::uint64_t rejected  = 0;
+            std::uint64_t overflows = 0;
+            std::uint64_t filtered  = 0; ///< Passed the socket filter, but not the full check.
+        };
+
+
+        /**
+         * Event filter, attached to the socket as a BPF program.
+         *
+         * The program only sees the hashes in the udev message header, so it
+         * checks subsystem, devtype, tags, and `SUBSYSTEM`/`DEVTYPE` property
+         * predicates; kernel messages pass it. Every event is checked again
+         * in full before the callback.
+         */
+        struct Filter {
+
+            /// Any may match: "subsystem" or "subsystem/devtype".
+            std::vector<std::string> subsystems;
+
+            /// Any may match.
+            std::vector<std::string> tags;
+
+            /// All must match exactly.
+            std::vector<std::pair<std::string, std::string>> properties;
+
+
+            bool
+            matches(const Uevent& event)
+                const;
+
+        }; // struct Filter
+
+
+        NetlinkMonitor(std::nullptr_t = nullptr)
+            noexcept;
+
+        /// Open a netlink socket bound to the multicast group.
+        explicit
+        NetlinkMonitor(Group group,
+                       std::size_t batch_size = 64);
+
+        /// Take ownership of an already open datagram socket (e.g. one end of a socketpair).
+        static
+        NetlinkMonitor
+        adopt(int fd,
+              std::size_t batch_size = 64);
+
+
+        ~NetlinkMonitor()
+            noexcept;
+
+        /// Move constructor.
+        NetlinkMonitor(NetlinkMonitor&& other)
+            noexcept;
+
+        /// Move assignment.
+        NetlinkMonitor&
+        operator =(NetlinkMonitor&& other)
+            noexcept;
+
+
+        void
+        destroy()
+            noexcept override;
+
+
+        int
+        fd()
+            const noexcept;
+
+
+        /// Set `SO_RCVBUF`; with `force`, `SO_RCVBUFFORCE` (needs `CAP_NET_ADMIN`).
+        void
+        set_receive_buffer_size(int bytes,
+                                bool force = false);
+
+
+        /// Replace the socket filter.
+        void
+        set_filter(const Filter& filter);
+
+        void
+        clear_filter();
+
+        const std::optional<Filter>&
+        filter()
+            const noexcept;
+
+
+        /// Only accept messages sent by root (default: true for netlink sockets).
+        bool check_credentials = true;
+
+        /// Called for every parsed event.
+        std::function<void (const Uevent& event)> uevent_callback;
+
+
+        /// Drain up to `batch_size` pending messages; returns how many events were delivered.
+        std::size_t
+        receive();
+
+
+        /**
+         * Dispatch events from the default GLib main context, receiving at
+         * most `max_batches` batches per main loop iteration, so a flood of
+         * events doesn't starve other sources.
+         */
+        void
+        attach(unsigned max_batches = 4);
+
+        void
+        detach()
+            noexcept;
+
+
+        Counters
+        counters()
+            const noexcept;
+
+
+        /// Parse a message in either the udev or the kernel wire format.
+        static
+        bool
+        parse(std::span<const char> message,
+              Uevent& event)
+            noexcept;
+
+    private:
+
+        struct Slots;
+
+        bool is_netlink = false;
+        std::unique_ptr<Slots> slots;
+        std::optional<Filter> event_filter;
+        unsigned source_id = 0;
+        unsigned dispatch_batches = 4;
+        Counters stats;
+
+
+        void
+        allocate_slots(std::size_t batch_size);
+
+    }; // class NetlinkMonitor
+
+} // namespace gudev
+
+#endif
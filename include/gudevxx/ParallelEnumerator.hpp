@@ -0,0 +1,62 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef LIBGUDEVXX_PARALLEL_ENUMERATOR_HPP
+#define LIBGUDEVXX_PARALLEL_ENUMERATOR_HPP
+
+#include <string>
+#include <vector>
+
+#include "Device.hpp"
+#include "MatchRules.hpp"
+
+
+namespace gudev {
+
+    /**
+     * Enumerate devices using multiple threads.
+     *
+     * The work is partitioned by subsystem, as found in `/sys/bus` and `/sys/class`.
+     * Each worker thread uses its own GUdevClient. The result is sorted by
+     * subsystem, then in the order returned by libudev for that subsystem.
+     */
+    class ParallelEnumerator {
+
+        MatchRules match_rules;
+        unsigned num_threads;
+
+    public:
+
+        /// Use `num_threads = 0` for one thread per hardware core.
+        explicit
+        ParallelEnumerator(MatchRules rules = {},
+                           unsigned num_threads = 0);
+
+
+        const MatchRules&
+        rules()
+            const noexcept;
+
+        MatchRules&
+        rules()
+            noexcept;
+
+
+        /// List the subsystems that will be enumerated, one per task.
+        std::vector<std::string>
+        subsystems()
+            const;
+
+
+        std::vector<Device>
+        execute();
+
+    }; // class ParallelEnumerator
+
+} // namespace gudev
+
+#endif
@@ -0,0 +1,110 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef LIBGUDEVXX_RULE_ENGINE_HPP
+#define LIBGUDEVXX_RULE_ENGINE_HPP
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Device.hpp"
+#include "zstring_view.hpp"
+
+
+namespace gudev {
+
+    struct Uevent;
+
+
+    /**
+     * Classifies devices and uevents against a large, fixed set of rules.
+     *
+     * The rules are compiled once: rules are bucketed by subsystem and action,
+     * and property patterns are indexed by key, with literal and prefix
+     * ("abc*") patterns stored in a trie. Evaluation walks the device's
+     * properties once, and returns the IDs of all matching rules.
+     *
+     * All patterns (except actions) are shell globs, as in `MatchRules`.
+     */
+    class RuleEngine {
+
+    public:
+
+        using rule_id = std::uint32_t;
+
+
+        struct Rule {
+
+            rule_id id = 0;
+
+            /// Any may match; empty means any subsystem.
+            std::vector<std::string> subsystems;
+
+            /// Exact action names; any may match, empty means any action.
+            std::vector<std::string> actions;
+
+            /// All must match.
+            std::vector<std::pair<std::string, std::string>> properties;
+
+            /// All must be present.
+            std::vector<std::string> tags;
+
+            /// All must match; never matches a `Uevent`, which has no sysfs attributes.
+            std::vector<std::pair<std::string, std::string>> sysfs_attrs;
+
+        }; // struct Rule
+
+
+        RuleEngine()
+            noexcept;
+
+        explicit
+        RuleEngine(std::span<const Rule> rules);
+
+        ~RuleEngine()
+            noexcept;
+
+        RuleEngine(RuleEngine&& other)
+            noexcept;
+
+        RuleEngine&
+        operator =(RuleEngine&& other)
+            noexcept;
+
+
+        std::size_t
+        size()
+            const noexcept;
+
+
+        /// IDs of matching rules, sorted; `action` overrides the device's own action.
+        std::vector<rule_id>
+        match(const Device& device,
+              std::optional<zstring_view> action = {})
+            const;
+
+        std::vector<rule_id>
+        match(const Uevent& event)
+            const;
+
+    private:
+
+        struct Compiled;
+
+        std::unique_ptr<Compiled> compiled;
+
+    }; // class RuleEngine
+
+} // namespace gudev
+
+#endif
@@ -0,0 +1,269 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef LIBGUDEVXX_SAMPLER_HPP
+#define LIBGUDEVXX_SAMPLER_HPP
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "Device.hpp"
+#include "zstring_view.hpp"
+
+
+namespace gudev {
+
+    /**
+     * Periodically samples numeric sysfs attributes into ring buffers.
+     *
+     * Each series keeps its attribute file open, and is re-read with
+     * `pread()` and parsed with `std::from_chars`. Series with the same
+     * period share a timerfd and a timestamp ring. Values are stored per
+     * type in structure-of-arrays columns, allocated when the series is
+     * added.
+     *
+     * Add all series before reading windows: adding a series may
+     * reallocate the columns. A series with a new period added after
+     * `start()` or `attach()` gets its timer armed and attached right away.
+     */
+    class Sampler {
+
+    public:
+
+        enum class Type {
+            u64,
+            i64,
+            f64
+        };
+
+
+        using series_id = std::size_t;
+
+
+        struct Counters {
+            std::uint64_t samples     = 0;
+            std::uint64_t read_errors = 0;
+            std::uint64_t overruns    = 0; ///< Timer expirations missed.
+        };
+
+
+        /// Samples of a series, oldest first, as two contiguous parts of the ring.
+        template<typename T>
+        struct Window {
+
+            std::array<std::span<const std::int64_t>, 2> timestamps; ///< CLOCK_MONOTONIC, in ns.
+            std::array<std::span<const T>, 2> values;
+            std::array<std::span<const std::uint8_t>, 2> valid;
+
+
+            std::size_t
+            size()
+                const noexcept
+            {
+                return values[0].size() + values[1].size();
+            }
+
+        }; // struct Window
+
+
+        /// `capacity` is the number of samples kept per series.
+        explicit
+        Sampler(std::size_t capacity = 1024);
+
+        ~Sampler()
+            noexcept;
+
+        Sampler(const Sampler&) = delete;
+
+
+        series_id
+        add(const Device& device,
+            zstring_view attr,
+            Type type,
+            std::chrono::milliseconds period);
+
+        series_id
+        add(const std::filesystem::path& sysfs_path,
+            zstring_view attr,
+            Type type,
+            std::chrono::milliseconds period);
+
+
+        std::size_t
+        size()
+            const noexcept;
+
+        std::size_t
+        capacity()
+            const noexcept;
+
+        Type
+        type(series_id id)
+            const;
+
+
+        /// Arm the timers.
+        void
+        start();
+
+        void
+        stop()
+            noexcept;
+
+
+        /// Sample the groups whose timers expired, without blocking; returns how many.
+        std::size_t
+        dispatch();
+
+        /// Sample every series now.
+        void
+        sample_all();
+
+
+        /// Dispatch from the default GLib main context.
+        void
+        attach();
+
+        void
+        detach()
+            noexcept;
+
+
+        /// The last `max` samples of a series; `T` must match its type.
+        template<typename T>
+        Window<T>
+        window(series_id id,
+               std::size_t max = std::numeric_limits<std::size_t>::max())
+            const;
+
+
+        Counters
+        counters()
+            const noexcept;
+
+    private:
+
+        struct Series {
+            int fd;
+            Type type;
+            std::size_t group;
+            // Index of this series within its type's column.
+            std::size_t slot;
+        };
+
+        struct Group {
+            std::chrono::milliseconds period;
+            int timer_fd = -1;
+            unsigned source_id = 0;
+            std::vector<series_id> members;
+            std::vector<std::int64_t> timestamps;
+            std::size_t head = 0;
+            std::size_t count = 0;
+        };
+
+        std::size_t cap;
+        std::vector<Series> series;
+        std::vector<Group> groups;
+
+        std::vector<std::uint64_t> u64_values;
+        std::vector<std::int64_t>  i64_values;
+        std::vector<double>        f64_values;
+        std::vector<std::uint8_t>  valid_flags; // indexed by series id
+
+        Counters stats;
+        bool started = false;
+        bool attached = false;
+
+
+        void
+        sample_group(std::size_t g);
+
+        void
+        arm_group(Group& g);
+
+        void
+        attach_group(Group& g);
+
+        static
+        gboolean
+        dispatch_timer(gint fd,
+                       GIOCondition condition,
+                       gpointer data)
+            noexcept;
+
+        template<typename T>
+        const std::vector<T>&
+        column()
+            const noexcept;
+
+    }; // class Sampler
+
+
+    template<typename T>
+    const std::vector<T>&
+    Sampler::column()
+        const noexcept
+    {
+        if constexpr (std::is_same_v<T, std::uint64_t>)
+            return u64_values;
+        else if constexpr (std::is_same_v<T, std::int64_t>)
+            return i64_values;
+        else {
+            static_assert(std::is_same_v<T, double>,
+                          "Sampler values are std::uint64_t, std::int64_t or double");
+            return f64_values;
+        }
+    }
+
+
+    template<typename T>
+    Sampler::Window<T>
+    Sampler::window(series_id id,
+                    std::size_t max)
+        const
+    {
+        const Series& s = series.at(id);
+        constexpr Type expected = std::is_same_v<T, std::uint64_t> ? Type::u64
+                                : std::is_same_v<T, std::int64_t> ? Type::i64
+                                : Type::f64;
+        if (s.type != expected)
+            throw std::invalid_argument{"Sampler::window(): wrong type"};
+
+        const Group& g = groups[s.group];
+        const std::size_t n = std::min(max, g.count);
+        const std::size_t start = (g.head + cap - n) % cap;
+        const std::size_t first = std::min(n, cap - start);
+
+        auto parts = [&](const auto* base)
+        {
+            using E = std::remove_cv_t<std::remove_pointer_t<decltype(base)>>;
+            return std::array<std::span<const E>, 2>{
+                std::span<const E>{base + start, first},
+                std::span<const E>{base, n - first}
+            };
+        };
+
+        Window<T> w;
+        w.timestamps = parts(g.timestamps.data());
+        w.values = parts(column<T>().data() + s.slot * cap);
+        w.valid = parts(valid_flags.data() + id * cap);
+        return w;
+    }
+
+} // namespace gudev
+
+#endif
@@ -0,0 +1,170 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef LIBGUDEVXX_STATS_HPP
+#define LIBGUDEVXX_STATS_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+
+namespace gudev {
+
+    /// Kinds of libgudev calls counted by the stats.
+    enum class Operation : unsigned {
+        query,
+        get,
+        enumerate,
+        property,
+        sysfs_attr,
+    };
+
+    inline constexpr std::size_t num_operations = 5;
+
+
+    /// Latency histogram with power-of-two buckets, in nanoseconds.
+    struct Histogram {
+
+        /// Bucket `i` counts durations in `[2^(i-1), 2^i)` ns; bucket 0 counts 0 ns.
+        static constexpr std::size_t num_buckets = 48;
+
+        std::array<std::uint64_t, num_buckets> buckets{};
+        std::uint64_t count  = 0;
+        std::uint64_t sum_ns = 0;
+        std::uint64_t max_ns = 0;
+
+
+        std::chrono::nanoseconds
+        mean()
+            const noexcept;
+
+        /// Upper bound of the bucket containing the `p` quantile (0 <= p <= 1).
+        std::chrono::nanoseconds
+        percentile(double p)
+            const noexcept;
+
+    }; // struct Histogram
+
+
+    /// A snapshot of the counters.
+    struct Stats {
+
+        /**
+         * libgudev calls by kind. `Device` methods don't know their client, so
+         * `property` and `sysfs_attr` calls are only counted globally; they
+         * stay 0 in a client's stats.
+         */
+        std::array<std::uint64_t, num_operations> calls{};
+        std::uint64_t devices_materialized = 0;
+        /// Events read from the monitor socket.
+        std::uint64_t events_received      = 0;
+        /// Events rejected by the client's subsystem filter.
+        std::uint64_t events_filtered      = 0;
+        /// Events the event queue discarded because it was full.
+        std::uint64_t events_dropped       = 0;
+        /// Queued events replaced by a later event for the same device.
+        std::uint64_t events_coalesced     = 0;
+        /// Events passed to the handlers.
+        std::uint64_t events_delivered     = 0;
+
+        /// Time spent in the uevent dispatch, including handlers.
+        Histogram dispatch_time;
+
+        /// Time spent in each user handler.
+        Histogram handler_time;
+
+
+        std::uint64_t
+        calls_for(Operation op)
+            const noexcept
+        {
+            return calls[static_cast<unsigned>(op)];
+        }
+
+    }; // struct Stats
+
+
+    namespace detail {
+
+        class AtomicHistogram {
+
+            std::array<std::atomic_uint64_t, Histogram::num_buckets> buckets{};
+            std::atomic_uint64_t count  = 0;
+            std::atomic_uint64_t sum_ns = 0;
+            std::atomic_uint64_t max_ns = 0;
+
+        public:
+
+            void
+            record(std::chrono::nanoseconds t)
+                noexcept;
+
+            Histogram
+            load()
+                const noexcept;
+
+            void
+            reset()
+                noexcept;
+
+        }; // class AtomicHistogram
+
+
+        struct StatsCounters {
+
+            std::array<std::atomic_uint64_t, num_operations> calls{};
+            std::atomic_uint64_t devices_materialized = 0;
+            std::atomic_uint64_t events_received      = 0;
+            std::atomic_uint64_t events_filtered      = 0;
+            std::atomic_uint64_t events_dropped       = 0;
+            std::atomic_uint64_t events_coalesced     = 0;
+            std::atomic_uint64_t events_delivered     = 0;
+            AtomicHistogram dispatch_time;
+            AtomicHistogram handler_time;
+
+
+            Stats
+            load()
+                const noexcept;
+
+            void
+            reset()
+                noexcept;
+
+        }; // struct StatsCounters
+
+    } // namespace detail
+
+
+    /// Process-wide stats, covering every Client, Device and Enumerator.
+    namespace stats {
+
+        /// Counting is disabled by default; when disabled, each call costs one relaxed load.
+        void
+        enable(bool enable = true)
+            noexcept;
+
+        bool
+        is_enabled()
+            noexcept;
+
+        Stats
+        snapshot()
+            noexcept;
+
+        void
+        reset()
+            noexcept;
+
+    } // namespace stats
+
+} // namespace gudev
+
+#endif
@@ -0,0 +1,97 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef LIBGUDEVXX_SYSFS_READER_HPP
+#define LIBGUDEVXX_SYSFS_READER_HPP
+
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "Device.hpp"
+#include "zstring_view.hpp"
+
+
+namespace gudev {
+
+    /// Attribute values for a list of devices, one row per device, one column per attribute.
+    struct SysfsAttrTable {
+
+        std::size_t num_devices = 0;
+        std::size_t num_attrs = 0;
+
+        /// Row-major; an empty value means the attribute could not be read.
+        std::vector<std::optional<std::string>> values;
+
+
+        const std::optional<std::string>&
+        at(std::size_t device,
+           std::size_t attr)
+            const
+        {
+            return values.at(device * num_attrs + attr);
+        }
+
+    }; // struct SysfsAttrTable
+
+
+    /**
+     * Reads many sysfs attributes of many devices at once.
+     *
+     * When built with `--enable-io-uring` and supported by the kernel, opens
+     * and reads are submitted to io_uring in batches of `queue_depth`;
+     * otherwise they're done with plain synchronous calls. If io_uring
+     * fails during a read, the rest is done synchronously, and io_uring is
+     * not used again by this reader. Unlike
+     * `Device::sysfs_attr()`, values are read directly from sysfs, without
+     * udev's cache. Trailing newlines are removed. Values that fill the
+     * first 4 KiB read are completed with synchronous reads, so long binary
+     * attributes are not truncated.
+     */
+    class SysfsReader {
+
+    public:
+
+        explicit
+        SysfsReader(unsigned queue_depth = 256);
+
+        ~SysfsReader()
+            noexcept;
+
+        SysfsReader(const SysfsReader&) = delete;
+
+
+        /// Check if io_uring is being used.
+        bool
+        uses_io_uring()
+            const noexcept;
+
+
+        SysfsAttrTable
+        read(std::span<const Device> devices,
+             std::span<const zstring_view> attrs);
+
+        SysfsAttrTable
+        read(std::span<const std::filesystem::path> sysfs_paths,
+             std::span<const zstring_view> attrs);
+
+    private:
+
+        struct Ring;
+
+        unsigned queue_depth;
+        std::unique_ptr<Ring> ring;
+
+    }; // class SysfsReader
+
+} // namespace gudev
+
+#endif
@@ -0,0 +1,102 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef LIBGUDEVXX_SYSFS_WALKER_HPP
+#define LIBGUDEVXX_SYSFS_WALKER_HPP
+
+#include <cstddef>
+#include <filesystem>
+#include <functional>
+#include <limits>
+#include <string_view>
+#include <vector>
+
+#include "Client.hpp"
+#include "Device.hpp"
+#include "MatchRules.hpp"
+
+
+namespace gudev {
+
+    struct Enumerator;
+
+
+    /**
+     * Enumeration engine that reads sysfs directly, without libudev.
+     *
+     * Walks `/sys/class/<subsystem>`, `/sys/bus/<subsystem>/devices` and
+     * `/sys/dev/{block,char}` with `openat()` and `getdents64()`, resolving
+     * each entry to its path under `/sys/devices`. Results are plain paths,
+     * so no GObject is created unless `devices()` is called.
+     *
+     * Only the subsystem, name, sysfs attribute and sysfs path rules can be
+     * evaluated; properties, tags and initialization live in the udev database,
+     * so rules using them are rejected with `std::invalid_argument`. Subsystem
+     * rules prune whole directories, and attributes are only read for devices
+     * that passed the other rules.
+     */
+    class SysfsWalker {
+
+    public:
+
+        /// Receives each matching sysfs path; return false to stop.
+        using visitor = std::function<bool (std::string_view sysfs_path)>;
+
+
+        explicit
+        SysfsWalker(MatchRules rules = {},
+                    std::filesystem::path sysfs_root = "/sys");
+
+        explicit
+        SysfsWalker(const Enumerator& etor,
+                    std::filesystem::path sysfs_root = "/sys");
+
+
+        const MatchRules&
+        rules()
+            const noexcept;
+
+        const std::filesystem::path&
+        sysfs_root()
+            const noexcept;
+
+
+        /**
+         * Call `visit` for each matching device, until it returns false.
+         *
+         * The path is only valid during the call. Returns how many paths were
+         * visited.
+         */
+        std::size_t
+        for_each(const visitor& visit)
+            const;
+
+        /// All matching sysfs paths.
+        std::vector<std::filesystem::path>
+        paths()
+            const;
+
+        /// Count matching devices, stopping at `limit`.
+        std::size_t
+        count(std::size_t limit = std::numeric_limits<std::size_t>::max())
+            const;
+
+        /// Look up each matching path through `client`.
+        std::vector<Device>
+        devices(Client& client)
+            const;
+
+    private:
+
+        MatchRules match_rules;
+        std::filesystem::path root;
+
+    }; // class SysfsWalker
+
+} // namespace gudev
+
+#endif
@@ -0,0 +1,152 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef LIBGUDEVXX_UDEV_DATABASE_HPP
+#define LIBGUDEVXX_UDEV_DATABASE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Device.hpp"
+
+
+namespace gudev {
+
+    /**
+     * Bulk reader for the udev database.
+     *
+     * `load()` reads every record in the data directory (normally
+     * `/run/udev/data`) into one buffer, and parses them in place: all
+     * strings are views into that buffer, valid until the next `load()` or
+     * until the database is destroyed. Records are sorted by device ID.
+     *
+     * This is a snapshot; udev may rewrite records at any time.
+     */
+    class UdevDatabase {
+
+    public:
+
+        struct Property {
+            std::string_view key;
+            std::string_view value;
+        };
+
+
+        struct Record {
+
+            /// Device ID, the file name: "b8:0", "c189:1", "n3", "+pci:0000:00:14.0".
+            std::string_view id;
+            /// Sorted by key.
+            std::span<const Property> properties;
+            std::span<const std::string_view> tags;
+            std::span<const std::string_view> current_tags;
+            /// Relative to `/dev`.
+            std::span<const std::string_view> symlinks;
+            std::optional<std::uint64_t> usec_initialized;
+            int devlink_priority = 0;
+
+
+            std::optional<std::string_view>
+            property(std::string_view key)
+                const noexcept;
+
+            bool
+            has_tag(std::string_view tag)
+                const noexcept;
+
+        }; // struct Record
+
+
+        /// Every record with a given property.
+        struct Match {
+            std::string_view id;
+            std::string_view value;
+        };
+
+
+        explicit
+        UdevDatabase(std::filesystem::path data_dir = "/run/udev/data");
+
+        UdevDatabase(const UdevDatabase&) = delete;
+
+        UdevDatabase(UdevDatabase&& other)
+            noexcept;
+
+        UdevDatabase&
+        operator =(UdevDatabase&& other)
+            noexcept;
+
+
+        const std::filesystem::path&
+        data_dir()
+            const noexcept;
+
+
+        /// Read all records again; throws `std::system_error` if the directory can't be read.
+        void
+        load();
+
+
+        std::size_t
+        size()
+            const noexcept;
+
+        bool
+        empty()
+            const noexcept;
+
+        std::span<const Record>
+        records()
+            const noexcept;
+
+
+        const Record*
+        find(std::string_view id)
+            const noexcept;
+
+        const Record*
+        find(const Device& device)
+            const;
+
+
+        /// All records that have `key`, in device ID order.
+        std::vector<Match>
+        find_property(std::string_view key)
+            const;
+
+        /// The value of `key` for each of `ids`, in input order.
+        std::vector<std::optional<std::string_view>>
+        property(std::span<const std::string_view> ids,
+                 std::string_view key)
+            const;
+
+
+        /// The ID of the database record for a device; empty if it can't have one.
+        static
+        std::string
+        device_id(const Device& device);
+
+    private:
+
+        std::filesystem::path dir;
+        std::vector<char> text;
+        std::vector<Record> table;
+        std::vector<Property> all_properties;
+        std::vector<std::string_view> all_strings;
+
+    }; // class UdevDatabase
+
+} // namespace gudev
+
+#endif
@@ -126,7 +126,7 @@ namespace gudev::detail {
             noexcept
         {
             auto old_raw = raw;
-            raw = {};
+            raw = invalid_value;
             return old_raw;
         }
 
@@ -10,6 +10,22 @@
 
 #include "Client.hpp"
 #include "Device.hpp"
+#include "DeviceRecord.hpp"
+#include "DeviceRegistry.hpp"
+#include "DeviceTable.hpp"
 #include "Enumerator.hpp"
+#include "EventQueue.hpp"
+#include "JsonWriter.hpp"
+#include "LiveQuery.hpp"
+#include "MatchRules.hpp"
+#include "MonitorHub.hpp"
+#include "NetlinkMonitor.hpp"
+#include "ParallelEnumerator.hpp"
+#include "RuleEngine.hpp"
+#include "Sampler.hpp"
+#include "Stats.hpp"
+#include "SysfsReader.hpp"
+#include "SysfsWalker.hpp"
+#include "UdevDatabase.hpp"
 
 #endif
@@ -0,0 +1,302 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef LIBGUDEVXX_STRV_VIEW_HPP
+#define LIBGUDEVXX_STRV_VIEW_HPP
+
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <ranges>
+#include <string_view>
+
+
+namespace gudev {
+
+    /**
+     * Non-owning view of a null-terminated array of C strings.
+     *
+     * Elements are accessed as `std::string_view`. The view is only valid while
+     * the array's owner (usually a `Device`) is alive.
+     */
+    class strv_view {
+
+        const char* const* strv = nullptr;
+        std::size_t count = 0;
+
+    public:
+
+        class iterator {
+
+            const char* const* ptr = nullptr;
+
+        public:
+
+            using iterator_concept  = std::random_access_iterator_tag;
+            using iterator_category = std::input_iterator_tag;
+            using value_type        = std::string_view;
+            using difference_type   = std::ptrdiff_t;
+            using reference         = std::string_view;
+
+
+            constexpr
+            iterator()
+                noexcept = default;
+
+            constexpr
+            explicit
+            iterator(const char* const* p)
+                noexcept :
+                ptr{p}
+            {}
+
+
+            constexpr
+            std::string_view
+            operator *()
+                const noexcept
+            {
+                return *ptr;
+            }
+
+            constexpr
+            std::string_view
+            operator [](difference_type n)
+                const noexcept
+            {
+                return ptr[n];
+            }
+
+
+            constexpr
+            iterator&
+            operator ++()
+                noexcept
+            {
+                ++ptr;
+                return *this;
+            }
+
+            constexpr
+            iterator
+            operator ++(int)
+                noexcept
+            {
+                auto old = *this;
+                ++ptr;
+                return old;
+            }
+
+            constexpr
+            iterator&
+            operator --()
+                noexcept
+            {
+                --ptr;
+                return *this;
+            }
+
+            constexpr
+            iterator
+            operator --(int)
+                noexcept
+            {
+                auto old = *this;
+                --ptr;
+                return old;
+            }
+
+
+            constexpr
+            iterator&
+            operator +=(difference_type n)
+                noexcept
+            {
+                ptr += n;
+                return *this;
+            }
+
+            constexpr
+            iterator&
+            operator -=(difference_type n)
+                noexcept
+            {
+                ptr -= n;
+                return *this;
+            }
+
+
+            friend
+            constexpr
+            iterator
+            operator +(iterator it,
+                       difference_type n)
+                noexcept
+            {
+                return it += n;
+            }
+
+            friend
+            constexpr
+            iterator
+            operator +(difference_type n,
+                       iterator it)
+                noexcept
+            {
+                return it += n;
+            }
+
+            friend
+            constexpr
+            iterator
+            operator -(iterator it,
+                       difference_type n)
+                noexcept
+            {
+                return it -= n;
+            }
+
+            friend
+            constexpr
+            difference_type
+            operator -(iterator a,
+                       iterator b)
+                noexcept
+            {
+                return a.ptr - b.ptr;
+            }
+
+
+            friend
+            constexpr
+            bool
+            operator ==(iterator a,
+                        iterator b)
+                noexcept = default;
+
+            friend
+            constexpr
+            std::strong_ordering
+            operator <=>(iterator a,
+                         iterator b)
+                noexcept = default;
+
+        }; // class iterator
+
+        using const_iterator  = iterator;
+        using value_type      = std::string_view;
+        using size_type       = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+
+        constexpr
+        strv_view()
+            noexcept = default;
+
+        /// Wrap a null-terminated array; a null `strv` is treated as empty.
+        constexpr
+        explicit
+        strv_view(const char* const* strv)
+            noexcept :
+            strv{strv}
+        {
+            if (strv)
+                while (strv[count])
+                    ++count;
+        }
+
+
+        [[nodiscard]]
+        constexpr
+        iterator
+        begin()
+            const noexcept
+        {
+            return iterator{strv};
+        }
+
+        [[nodiscard]]
+        constexpr
+        iterator
+        end()
+            const noexcept
+        {
+            return iterator{strv + count};
+        }
+
+
+        [[nodiscard]]
+        constexpr
+        std::size_t
+        size()
+            const noexcept
+        {
+            return count;
+        }
+
+        [[nodiscard]]
+        constexpr
+        bool
+        empty()
+            const noexcept
+        {
+            return count == 0;
+        }
+
+
+        /// Access element; the returned view is also null-terminated.
+        [[nodiscard]]
+        constexpr
+        std::string_view
+        operator [](std::size_t idx)
+            const noexcept
+        {
+            return strv[idx];
+        }
+
+        /// Like `operator []`, but as a C string.
+        [[nodiscard]]
+        constexpr
+        const char*
+        c_str(std::size_t idx)
+            const noexcept
+        {
+            return strv[idx];
+        }
+
+
+        [[nodiscard]]
+        constexpr
+        bool
+        contains(std::string_view str)
+            const noexcept
+        {
+            for (std::size_t i = 0; i < count; ++i)
+                if (strv[i] == str)
+                    return true;
+            return false;
+        }
+
+
+        [[nodiscard]]
+        constexpr
+        const char* const*
+        data()
+            const noexcept
+        {
+            return strv;
+        }
+
+    }; // class strv_view
+
+} // namespace gudev
+
+
+template<>
+inline constexpr bool std::ranges::enable_borrowed_range<gudev::strv_view> = true;
+
+#endif
@@ -0,0 +1,90 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef LIBGUDEVXX_UDEV_CLIENT_HPP
+#define LIBGUDEVXX_UDEV_CLIENT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+#include <libudev.h>
+
+#include "../zstring_view.hpp"
+#include "Device.hpp"
+#include "UdevWrapper.hpp"
+
+
+namespace gudev::udev {
+
+    /**
+     * Query operations of `gudev::Client`, implemented directly on a `udev` context.
+     *
+     * To listen for events, use `Monitor`.
+     */
+    class Client :
+        public detail::UdevWrapper<struct udev, udev_ref, udev_unref> {
+
+        using BaseType = detail::UdevWrapper<struct udev, udev_ref, udev_unref>;
+
+    public:
+
+        /// Create a new udev context.
+        Client();
+
+        /// Construct invalid (null) client.
+        Client(std::nullptr_t)
+            noexcept;
+
+
+        void
+        create();
+
+
+        Client(const Client& other)
+            noexcept = default;
+
+        Client&
+        operator =(const Client& other)
+            noexcept = default;
+
+        /// Move constructor.
+        Client(Client&& other)
+            noexcept = default;
+
+        /// Move assignment.
+        Client&
+        operator =(Client&& other)
+            noexcept = default;
+
+
+        // query operations
+
+        std::vector<Device>
+        query(zstring_view subsystem = {});
+
+        std::optional<Device>
+        get(zstring_view subsystem,
+            zstring_view name);
+
+        std::optional<Device>
+        get(Device::Type type,
+            std::uint64_t number);
+
+        std::optional<Device>
+        get(const std::filesystem::path& device_path);
+
+        std::optional<Device>
+        get_sysfs(const std::filesystem::path& sysfs_path);
+
+    }; // class Client
+
+} // namespace gudev::udev
+
+#endif
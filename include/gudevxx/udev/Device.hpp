@@ -0,0 +1,203 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef LIBGUDEVXX_UDEV_DEVICE_HPP
+#define LIBGUDEVXX_UDEV_DEVICE_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <libudev.h>
+
+#include "../zstring_view.hpp"
+#include "UdevWrapper.hpp"
+
+
+namespace gudev::udev {
+
+    /**
+     * Same API as `gudev::Device`, implemented directly on `udev_device`.
+     *
+     * Copies share the underlying `udev_device`.
+     */
+    class Device :
+        public detail::UdevWrapper<udev_device, udev_device_ref, udev_device_unref> {
+
+    public:
+
+        using BaseType = detail::UdevWrapper<udev_device, udev_device_ref, udev_device_unref>;
+
+
+        Device(std::nullptr_t = nullptr)
+            noexcept;
+
+        Device(const Device& other)
+            noexcept = default;
+
+        Device&
+        operator =(const Device& other)
+            noexcept = default;
+
+        /// Move constructor.
+        Device(Device&& other)
+            noexcept = default;
+
+        /// Move assignment.
+        Device&
+        operator =(Device&& other)
+            noexcept = default;
+
+
+        enum class Type {
+            no_device    = 0,
+            block_device = 'b',
+            char_device  = 'c'
+        };
+
+
+        std::optional<std::string>
+        subsystem()
+            const;
+
+        std::optional<std::string>
+        devtype()
+            const;
+
+        std::optional<std::string>
+        name()
+            const;
+
+        std::optional<std::string>
+        number()
+            const;
+
+        std::optional<std::filesystem::path>
+        sysfs()
+            const;
+
+        std::optional<std::string>
+        driver()
+            const;
+
+        std::optional<std::string>
+        action()
+            const;
+
+        std::optional<std::uint64_t>
+        seqnum()
+            const;
+
+        Type
+        type()
+            const;
+
+        std::optional<std::uint64_t>
+        device_number()
+            const;
+
+        std::optional<std::filesystem::path>
+        device_file()
+            const;
+
+        std::vector<std::filesystem::path>
+        device_symlinks()
+            const;
+
+        std::optional<Device>
+        parent()
+            const;
+
+        std::optional<Device>
+        parent(zstring_view subsystem)
+            const;
+
+        std::optional<Device>
+        parent(zstring_view subsystem,
+               zstring_view devtype)
+            const;
+
+        std::vector<std::string>
+        tags()
+            const;
+
+        bool
+        has_tag(zstring_view tag)
+            const;
+
+        bool
+        is_initialized()
+            const;
+
+        std::chrono::microseconds
+        usec_since_initialized()
+            const;
+
+        std::vector<std::string>
+        property_keys()
+            const;
+
+        bool
+        has_property(zstring_view key)
+            const;
+
+        std::optional<std::string>
+        property(zstring_view key)
+            const;
+
+        // T = int, uint64_t, double, bool, string
+        template<typename T>
+        T
+        property_as(zstring_view key)
+            const;
+
+
+        std::vector<std::string>
+        sysfs_attr_keys()
+            const;
+
+        bool
+        has_sysfs_attr(zstring_view key)
+            const;
+
+        std::optional<std::string>
+        sysfs_attr(zstring_view key)
+            const;
+
+        // T = int, uint64_t, double, bool, string
+        template<typename T>
+        T
+        sysfs_attr_as(zstring_view key)
+            const;
+
+
+        /// Wrap a `udev_device`, taking ownership of the reference.
+        static
+        Device
+        make_owner(udev_device* dev)
+            noexcept;
+
+        /// Wrap a `udev_device`, taking a new reference.
+        static
+        Device
+        make_alias(udev_device* dev)
+            noexcept;
+
+    private:
+
+        // Inherit constructors.
+        using BaseType::BaseType;
+
+    }; // class Device
+
+} // namespace gudev::udev
+
+#endif
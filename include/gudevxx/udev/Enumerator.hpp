@@ -0,0 +1,84 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef LIBGUDEVXX_UDEV_ENUMERATOR_HPP
+#define LIBGUDEVXX_UDEV_ENUMERATOR_HPP
+
+#include <cstddef>
+#include <filesystem>
+#include <vector>
+
+#include <libudev.h>
+
+#include "../zstring_view.hpp"
+#include "Client.hpp"
+#include "Device.hpp"
+#include "UdevWrapper.hpp"
+
+
+namespace gudev::udev {
+
+    /// Same API as `gudev::Enumerator`, implemented directly on `udev_enumerate`.
+    struct Enumerator :
+        detail::UdevWrapper<udev_enumerate, udev_enumerate_ref, udev_enumerate_unref> {
+
+        using BaseType = detail::UdevWrapper<udev_enumerate, udev_enumerate_ref, udev_enumerate_unref>;
+
+
+        Enumerator(std::nullptr_t = nullptr)
+            noexcept;
+
+        Enumerator(Client& client);
+
+
+        void
+        create(Client& client);
+
+
+        Enumerator&
+        match_subsystem(zstring_view subsystem);
+
+        Enumerator&
+        nomatch_subsystem(zstring_view subsystem);
+
+        Enumerator&
+        match_sysfs_attr(zstring_view key,
+                         zstring_view val);
+
+        Enumerator&
+        nomatch_sysfs_attr(zstring_view key,
+                           zstring_view val);
+
+        Enumerator&
+        match_property(zstring_view key,
+                       zstring_view val);
+
+        Enumerator&
+        match_name(zstring_view name);
+
+        Enumerator&
+        match_tag(zstring_view tag);
+
+        Enumerator&
+        match_initialized();
+
+        Enumerator&
+        add_sysfs_path(const std::filesystem::path& sysfs_path);
+
+
+        std::vector<Device>
+        execute();
+
+        /// Only list the sysfs paths, without creating any device.
+        std::vector<std::filesystem::path>
+        execute_paths();
+
+    };
+
+} // namespace gudev::udev
+
+#endif
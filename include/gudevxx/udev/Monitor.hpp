@@ -0,0 +1,69 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef LIBGUDEVXX_UDEV_MONITOR_HPP
+#define LIBGUDEVXX_UDEV_MONITOR_HPP
+
+#include <cstddef>
+#include <optional>
+#include <span>
+
+#include <libudev.h>
+
+#include "../zstring_view.hpp"
+#include "Client.hpp"
+#include "Device.hpp"
+#include "UdevWrapper.hpp"
+
+
+namespace gudev::udev {
+
+    /**
+     * Receives uevents from udev, without any event loop.
+     *
+     * Poll `fd()` for input with your own loop, then call `receive()`.
+     */
+    class Monitor :
+        public detail::UdevWrapper<udev_monitor, udev_monitor_ref, udev_monitor_unref> {
+
+        using BaseType = detail::UdevWrapper<udev_monitor, udev_monitor_ref, udev_monitor_unref>;
+
+    public:
+
+        Monitor(std::nullptr_t = nullptr)
+            noexcept;
+
+        /**
+         * Listen for events in the given subsystems ("subsystem" or
+         * "subsystem/devtype"), for devices with any of the given tags.
+         *
+         * Both filters are applied by the kernel, before the process wakes up.
+         */
+        Monitor(Client& client,
+                std::span<const zstring_view> subsystems = {},
+                std::span<const zstring_view> tags = {});
+
+
+        void
+        create(Client& client,
+               std::span<const zstring_view> subsystems = {},
+               std::span<const zstring_view> tags = {});
+
+
+        int
+        fd()
+            const noexcept;
+
+        /// Receive one event, or nothing if none is pending.
+        std::optional<Device>
+        receive();
+
+    }; // class Monitor
+
+} // namespace gudev::udev
+
+#endif
@@ -0,0 +1,96 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef LIBGUDEVXX_UDEV_UDEV_WRAPPER_HPP
+#define LIBGUDEVXX_UDEV_UDEV_WRAPPER_HPP
+
+#include "../basic_wrapper.hpp"
+
+
+namespace gudev::udev::detail {
+
+    /// Wrapper for reference-counted libudev objects; copies share a reference.
+    template<typename CType,
+             CType* (*RefFunc)(CType*),
+             CType* (*UnrefFunc)(CType*)>
+    class UdevWrapper :
+        public gudev::detail::basic_wrapper<CType*> {
+
+        using BaseType = gudev::detail::basic_wrapper<CType*>;
+
+    protected:
+
+        // Inherit constructors.
+        using BaseType::BaseType;
+
+
+        ~UdevWrapper()
+            noexcept
+        {
+            this->destroy();
+        }
+
+
+        UdevWrapper()
+            noexcept = default;
+
+
+        UdevWrapper(const UdevWrapper& other)
+            noexcept :
+            BaseType{other.raw ? RefFunc(other.raw) : nullptr}
+        {}
+
+
+        UdevWrapper&
+        operator =(const UdevWrapper& other)
+            noexcept
+        {
+            if (this != &other) {
+                this->destroy();
+                if (other.raw)
+                    this->acquire(RefFunc(other.raw));
+            }
+            return *this;
+        }
+
+
+        /// Move constructor.
+        UdevWrapper(UdevWrapper&& other)
+            noexcept = default;
+
+        /// Move assignment.
+        UdevWrapper&
+        operator =(UdevWrapper&& other)
+            noexcept = default;
+
+    public:
+
+        void
+        destroy()
+            noexcept override
+        {
+            auto ptr = this->release();
+            if (ptr)
+                UnrefFunc(ptr);
+        }
+
+
+        /// Take an extra reference, and hold it.
+        void
+        alias(CType* new_raw)
+            noexcept
+        {
+            this->destroy();
+            if (new_raw)
+                this->acquire(RefFunc(new_raw));
+        }
+
+    }; // class UdevWrapper
+
+} // namespace gudev::udev::detail
+
+#endif
@@ -0,0 +1,92 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef LIBGUDEVXX_ZSTRING_VIEW_HPP
+#define LIBGUDEVXX_ZSTRING_VIEW_HPP
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+
+namespace gudev {
+
+    /**
+     * Non-owning view of a null-terminated string.
+     *
+     * Used for lookup parameters, so string literals, C strings and
+     * `std::string` can be passed down to libgudev without allocating.
+     */
+    class zstring_view {
+
+        const char* ptr = "";
+
+    public:
+
+        constexpr
+        zstring_view()
+            noexcept = default;
+
+        constexpr
+        zstring_view(std::nullptr_t)
+            noexcept
+        {}
+
+        constexpr
+        zstring_view(const char* str)
+            noexcept :
+            ptr{str ? str : ""}
+        {}
+
+        zstring_view(const std::string& str)
+            noexcept :
+            ptr{str.c_str()}
+        {}
+
+
+        [[nodiscard]]
+        constexpr
+        const char*
+        c_str()
+            const noexcept
+        {
+            return ptr;
+        }
+
+
+        [[nodiscard]]
+        constexpr
+        bool
+        empty()
+            const noexcept
+        {
+            return *ptr == '\0';
+        }
+
+
+        [[nodiscard]]
+        constexpr
+        std::string_view
+        view()
+            const noexcept
+        {
+            return ptr;
+        }
+
+
+        constexpr
+        operator std::string_view()
+            const noexcept
+        {
+            return view();
+        }
+
+    }; // class zstring_view
+
+} // namespace gudev
+
+#endif
@@ -47,6 +47,20 @@ This package provides libraries and headers files for %{name}
 development.
 
 
+###########
+## tools ##
+###########
+
+%package -n     gudevxx-tools
+Summary:        Command-line tools built on %{libname}.
+Group:          System/Configuration/Hardware
+Requires:       %{libname} = %{version}-%{release}
+
+%description -n gudevxx-tools
+This package provides gudevxx-dump, which exports the udev device
+database as NDJSON.
+
+
 ##################
 ## static-devel ##
 ##################
@@ -107,3 +121,11 @@ This package provides static libraries for %{name} development.
 %{_libdir}/*.a
 %{_libdir}/pkgconfig/*.pc
 
+
+###################
+## package tools ##
+###################
+
+%files -n gudevxx-tools
+%doc README.md
+%{_bindir}/gudevxx-dump
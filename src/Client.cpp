@@ -5,11 +5,25 @@
  * SPDX-License-Identifier: GPL-3.0-or-later
  */
 
+#include <algorithm>
+#include <deque>
+#include <exception>
+#include <map>
 #include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
 #include <utility>
 
+#include <sys/stat.h>
+
 #include "gudevxx/Client.hpp"
 
+#include "gudevxx/MonitorHub.hpp"
+
+#include "probes.hpp"
+#include "stats.hpp"
+#include "sysfs_trie.hpp"
 #include "utils.hpp"
 
 
@@ -17,6 +31,31 @@ namespace gudev {
 
     namespace {
 
+        // Filter entries are "subsystem" or "subsystem/devtype".
+        bool
+        filter_accepts(const std::vector<std::string>& filter,
+                       GUdevDevice* dev)
+        {
+            const char* subsystem = g_udev_device_get_subsystem(dev);
+            if (!subsystem)
+                return false;
+            const std::string_view sub = subsystem;
+            return std::ranges::any_of(filter,
+                                       [dev, sub](const std::string& entry)
+                                       {
+                                           auto slash = entry.find('/');
+                                           if (slash == std::string::npos)
+                                               return entry == sub;
+                                           if (std::string_view{entry}.substr(0, slash) != sub)
+                                               return false;
+                                           const char* devtype = g_udev_device_get_devtype(dev);
+                                           return devtype && entry.compare(slash + 1,
+                                                                           std::string::npos,
+                                                                           devtype) == 0;
+                                       });
+        }
+
+
         GUdevClient*
         make_filter_client(const std::vector<std::string>& subsystems)
         {
@@ -27,9 +66,289 @@ namespace gudev {
             return g_udev_client_new(filter.data());
         }
 
+
+        GUdevClient*
+        make_filter_client(std::span<const zstring_view> subsystems)
+        {
+            std::vector<const char*> filter;
+            filter.reserve(subsystems.size() + 1);
+            for (auto& s : subsystems)
+                filter.push_back(s.c_str());
+            filter.push_back(nullptr);
+            return g_udev_client_new(filter.data());
+        }
+
+
+
+        using devnum_key = std::pair<GUdevDeviceType, GUdevDeviceNumber>;
+
+
+        /*
+         * Look up each distinct key once, possibly in parallel, and map the
+         * results back to the inputs. Inputs without a key give no device.
+         */
+        template<typename Key,
+                 typename Lookup>
+        std::vector<std::optional<Device>>
+        batch_lookup(GUdevClient* cli,
+                     const std::vector<std::optional<Key>>& keys,
+                     unsigned num_threads,
+                     Lookup lookup)
+        {
+            std::vector<Key> unique;
+            unique.reserve(keys.size());
+            for (auto& k : keys)
+                if (k)
+                    unique.push_back(*k);
+            std::ranges::sort(unique);
+            auto [last, end] = std::ranges::unique(unique);
+            unique.erase(last, end);
+
+            std::vector<GUdevDevice*> found(unique.size(), nullptr);
+
+            auto resolve = [&](GUdevClient* c,
+                               std::size_t first,
+                               std::size_t stop)
+            {
+                for (std::size_t i = first; i < stop; ++i)
+                    found[i] = lookup(c, unique[i]);
+            };
+
+            num_threads = std::clamp<unsigned>(num_threads, 1, std::max<std::size_t>(unique.size(), 1));
+            if (num_threads == 1)
+                resolve(cli, 0, unique.size());
+            else {
+                std::vector<std::exception_ptr> errors(num_threads);
+                const std::size_t chunk = (unique.size() + num_threads - 1) / num_threads;
+                {
+                    std::vector<std::jthread> threads;
+                    for (unsigned t = 0; t < num_threads; ++t)
+                        threads.emplace_back([&, t]
+                        {
+                            try {
+                                Client worker;
+                                std::size_t first = t * chunk;
+                                std::size_t stop = std::min(first + chunk, unique.size());
+                                resolve(worker.data(), first, stop);
+                            }
+                            catch (...) {
+                                errors[t] = std::current_exception();
+                            }
+                        });
+                }
+                for (auto& e : errors)
+                    if (e) {
+                        for (auto d : found)
+                            if (d)
+                                g_object_unref(d);
+                        std::rethrow_exception(e);
+                    }
+            }
+
+            // Take ownership of the lookup references first, so they're released on any exit.
+            std::vector<Device> owners;
+            owners.reserve(found.size());
+            for (auto d : found)
+                owners.push_back(Device::make_owner(d));
+
+            std::vector<std::optional<Device>> result(keys.size());
+            for (std::size_t i = 0; i < keys.size(); ++i) {
+                if (!keys[i])
+                    continue;
+                auto it = std::ranges::lower_bound(unique, *keys[i]);
+                auto& owner = owners[it - unique.begin()];
+                if (owner)
+                    result[i] = Device::make_alias(owner.data());
+            }
+            return result;
+        }
+
+
+        // splitmix64's finalizer: every input bit affects every output bit.
+        std::uint64_t
+        mix(std::uint64_t x)
+            noexcept
+        {
+            x ^= x >> 30;
+            x *= 0xbf58476d1ce4e5b9;
+            x ^= x >> 27;
+            x *= 0x94d049bb133111eb;
+            x ^= x >> 31;
+            return x;
+        }
+
+
+        /*
+         * Order-independent hash of the properties that describe the device,
+         * not the event. Each key/value pair is mixed before being summed, so
+         * swapped values or cancelling pairs don't collide.
+         */
+        std::size_t
+        fingerprint(const Device& device)
+        {
+            using namespace std::literals;
+            GUdevDevice* dev = device.data();
+            std::uint64_t result = 0;
+            std::uint64_t count = 0;
+            auto keys = device.property_keys_view();
+            for (std::size_t i = 0; i < keys.size(); ++i) {
+                auto key = keys[i];
+                if (key == "ACTION"sv || key == "SEQNUM"sv
+                    || key == "DEVPATH_OLD"sv || key == "SYNTH_UUID"sv)
+                    continue;
+                const char* val = g_udev_device_get_property(dev, keys.c_str(i));
+                const std::uint64_t hk = std::hash<std::string_view>{}(key);
+                const std::uint64_t hv = std::hash<std::string_view>{}(val ? val : "");
+                result += mix(hk + 0x9e3779b97f4a7c15 + mix(hv));
+                ++count;
+            }
+            return mix(result + count);
+        }
+
     } // namespace
 
 
+    namespace detail {
+
+        struct SeqnumTracker {
+
+            struct Known {
+                Device device;
+                std::size_t fingerprint;
+            };
+
+
+            unsigned reorder_window;
+            bool auto_resync = false;
+            Client::SeqnumStats counters;
+            // Missing seqnums not yet reported, as first -> last.
+            std::map<std::uint64_t, std::uint64_t> missing;
+            std::map<std::string, Known, std::less<>> known;
+            bool has_view = false;
+            // Subsystems of the latest events, to scope a resync to the ones around a gap.
+            std::deque<std::pair<std::uint64_t, std::string>> recent;
+
+
+            explicit
+            SeqnumTracker(unsigned window) :
+                reorder_window{std::max(window, 1u)}
+            {}
+
+
+            // Returns the gaps confirmed by this seqnum.
+            std::vector<std::pair<std::uint64_t, std::uint64_t>>
+            observe(std::uint64_t seqnum)
+            {
+                std::vector<std::pair<std::uint64_t, std::uint64_t>> confirmed;
+                if (!seqnum)
+                    return confirmed;
+
+                auto& highest = counters.last_seqnum;
+                if (!highest) {
+                    highest = seqnum;
+                    return confirmed;
+                }
+
+                if (seqnum > *highest) {
+                    if (seqnum > *highest + 1)
+                        missing.emplace(*highest + 1, seqnum - 1);
+                    highest = seqnum;
+                } else {
+                    // A late event: remove it from the missing ranges, if it's there.
+                    auto it = missing.upper_bound(seqnum);
+                    if (it != missing.begin()) {
+                        --it;
+                        auto [first, last] = *it;
+                        if (seqnum <= last) {
+                            ++counters.reordered;
+                            missing.erase(it);
+                            if (first < seqnum)
+                                missing.emplace(first, seqnum - 1);
+                            if (seqnum < last)
+                                missing.emplace(seqnum + 1, last);
+                        }
+                    }
+                }
+
+                while (!missing.empty()
+                       && *highest - missing.begin()->second > reorder_window) {
+                    auto [first, last] = *missing.begin();
+                    missing.erase(missing.begin());
+                    ++counters.gaps;
+                    counters.dropped += last - first + 1;
+                    confirmed.emplace_back(first, last);
+                }
+
+                return confirmed;
+            }
+
+
+            void
+            note(std::uint64_t seqnum,
+                 const char* subsystem)
+            {
+                if (!seqnum || !subsystem)
+                    return;
+                recent.emplace_back(seqnum, subsystem);
+                while (recent.size() > 2 * std::size_t{reorder_window})
+                    recent.pop_front();
+            }
+
+
+            // Subsystems of the events received within the reorder window of a gap.
+            std::vector<std::string>
+            subsystems_near(std::uint64_t first,
+                            std::uint64_t last)
+                const
+            {
+                const std::uint64_t lo = first > reorder_window ? first - reorder_window : 0;
+                const std::uint64_t hi = last + reorder_window;
+                std::vector<std::string> result;
+                for (auto& [seqnum, subsystem] : recent)
+                    if (seqnum >= lo && seqnum <= hi
+                        && std::ranges::find(result, subsystem) == result.end())
+                        result.push_back(subsystem);
+                return result;
+            }
+
+
+            void
+            update(const std::string& action,
+                   Device& device)
+            {
+                const char* path = g_udev_device_get_sysfs_path(device.data());
+                if (!path)
+                    return;
+                if (action == "remove") {
+                    if (auto it = known.find(std::string_view{path}); it != known.end())
+                        known.erase(it);
+                    return;
+                }
+                if (action == "move")
+                    if (auto old_path = device.property("DEVPATH_OLD"))
+                        known.erase("/sys" + *old_path);
+                known.insert_or_assign(path,
+                                       Known{Device::make_alias(device.data()),
+                                             fingerprint(device)});
+            }
+
+        }; // struct SeqnumTracker
+
+
+        struct SubtreeWatches {
+
+            SysfsTrie trie;
+            // Shared, so a callback survives being unwatched while it runs.
+            std::unordered_map<Client::watch_id,
+                               std::pair<std::string,
+                                         std::shared_ptr<Client::subtree_callback>>> watches;
+            Client::watch_id next_id = 1;
+
+        }; // struct SubtreeWatches
+
+    } // namespace detail
+
+
 
     Client::Client()
     {
@@ -48,6 +367,19 @@ namespace gudev {
     }
 
 
+    Client::Client(std::span<const zstring_view> subsystems)
+    {
+        create(subsystems);
+    }
+
+
+    Client::Client(shared_t,
+                   const std::vector<std::string>& subsystems)
+    {
+        create(shared, subsystems);
+    }
+
+
     void
     Client::create()
     {
@@ -56,6 +388,7 @@ namespace gudev {
             throw std::runtime_error{"Could not create new GUdevClient"};
         destroy();
         acquire(ptr);
+        subsystem_filter.clear();
         connect_uevent_handler();
     }
 
@@ -68,7 +401,51 @@ namespace gudev {
             throw std::runtime_error{"Could not create new GUdevClient"};
         destroy();
         acquire(ptr);
+        subsystem_filter = subsystems;
+        connect_uevent_handler();
+        if (!subsystem_filter.empty())
+            set_auto_resync(false);
+    }
+
+
+    void
+    Client::create(std::span<const zstring_view> subsystems)
+    {
+        auto ptr = make_filter_client(subsystems);
+        if (!ptr)
+            throw std::runtime_error{"Could not create new GUdevClient"};
+        destroy();
+        acquire(ptr);
+        subsystem_filter.assign(subsystems.begin(), subsystems.end());
+        connect_uevent_handler();
+        if (!subsystem_filter.empty())
+            set_auto_resync(false);
+    }
+
+
+    void
+    Client::create(shared_t,
+                   const std::vector<std::string>& subsystems)
+    {
+        // Without subsystems, the GUdevClient opens no socket of its own.
+        auto ptr = g_udev_client_new(nullptr);
+        if (!ptr)
+            throw std::runtime_error{"Could not create new GUdevClient"};
+        destroy();
+        acquire(ptr);
+        subsystem_filter = subsystems;
         connect_uevent_handler();
+        MonitorHub::instance().add(raw, subsystems);
+        shared_monitor = true;
+        set_auto_resync(false);
+    }
+
+
+    bool
+    Client::is_shared()
+        const noexcept
+    {
+        return shared_monitor;
     }
 
 
@@ -76,11 +453,26 @@ namespace gudev {
     Client::destroy()
         noexcept
     {
+        // A moved-from client has no raw pointer, and must not remove the source.
+        if (raw && queue_source)
+            g_source_remove(queue_source);
+        queue_source = 0;
+        if (raw && shared_monitor)
+            MonitorHub::instance().remove(raw);
+        shared_monitor = false;
         disconnect_uevent_handler();
         BaseType::destroy();
     }
 
 
+    // ~GObjectWrapper() can't dispatch to Client::destroy(), so call it here.
+    Client::~Client()
+        noexcept
+    {
+        destroy();
+    }
+
+
     Client::Client(Client&& other)
         noexcept = default;
 
@@ -116,34 +508,396 @@ namespace gudev {
     }
 
 
+    void
+    Client::enable_stats(bool enable)
+    {
+        if (!enable)
+            stats_counters.reset();
+        else if (!stats_counters)
+            stats_counters = std::make_unique<detail::StatsCounters>();
+    }
+
+
+    bool
+    Client::stats_enabled()
+        const noexcept
+    {
+        return bool(stats_counters);
+    }
+
+
+    Stats
+    Client::stats()
+        const noexcept
+    {
+        if (stats_counters)
+            return stats_counters->load();
+        return {};
+    }
+
+
+    void
+    Client::reset_stats()
+        noexcept
+    {
+        if (stats_counters)
+            stats_counters->reset();
+    }
+
+
+    /*-------------*/
+    /* event queue */
+    /*-------------*/
+
+
+    void
+    Client::enable_event_queue(const EventQueue::Options& options)
+    {
+        if (queue)
+            process_events();
+        queue = std::make_unique<EventQueue>(options);
+    }
+
+
+    void
+    Client::disable_event_queue()
+    {
+        if (!queue)
+            return;
+        process_events();
+        queue.reset();
+        if (queue_source) {
+            g_source_remove(queue_source);
+            queue_source = 0;
+        }
+    }
+
+
+    EventQueue*
+    Client::event_queue()
+        noexcept
+    {
+        return queue.get();
+    }
+
+
+    const EventQueue*
+    Client::event_queue()
+        const noexcept
+    {
+        return queue.get();
+    }
+
+
+    std::size_t
+    Client::process_events(std::size_t max)
+    {
+        if (!queue)
+            return 0;
+        return queue->drain(queue_handler(), max);
+    }
+
+
+    EventQueue::handler_type
+    Client::queue_handler()
+    {
+        return [this](const std::string& action, Device& device)
+        {
+            deliver_uevent(action, device);
+        };
+    }
+
+
+    void
+    Client::post_uevent(const std::string& action,
+                        Device& device)
+    {
+        if (!queue) {
+            deliver_uevent(action, device);
+            return;
+        }
+        const auto before = queue->counters();
+        queue->push(action, device, queue_handler());
+        const auto after = queue->counters();
+        if (auto dropped = after.dropped - before.dropped)
+            stats::add(&detail::StatsCounters::events_dropped, dropped, stats_counters.get());
+        if (auto coalesced = after.coalesced - before.coalesced)
+            stats::add(&detail::StatsCounters::events_coalesced, coalesced, stats_counters.get());
+        // The source holds its own reference, so it never sees a freed client,
+        // even if it outlives this wrapper.
+        if (!queue_source && !queue->empty())
+            queue_source = g_idle_add_full(G_PRIORITY_DEFAULT_IDLE,
+                                           dispatch_queue_idle,
+                                           g_object_ref(raw),
+                                           g_object_unref);
+    }
+
+
+    gboolean
+    Client::dispatch_queue_idle(gpointer data)
+        noexcept
+    {
+        Client* client = get_wrapper(static_cast<GUdevClient*>(data));
+        if (!client)
+            return G_SOURCE_REMOVE;
+        try {
+            if (client->queue) {
+                client->process_events(client->queue->options().batch_size);
+                if (client->queue && !client->queue->empty())
+                    return G_SOURCE_CONTINUE;
+            }
+        }
+        catch (std::exception& e) {
+            g_warning("Exception in event queue handler: %s\n", e.what());
+            if (client->queue && !client->queue->empty())
+                return G_SOURCE_CONTINUE;
+        }
+        client->queue_source = 0;
+        return G_SOURCE_REMOVE;
+    }
+
+
+    /*-----------------*/
+    /* seqnum tracking */
+    /*-----------------*/
+
+
+    void
+    Client::enable_seqnum_tracking(bool enable,
+                                   unsigned reorder_window)
+    {
+        if (!enable)
+            seqnum_tracker.reset();
+        else if (!seqnum_tracker)
+            seqnum_tracker = std::make_unique<detail::SeqnumTracker>(reorder_window);
+        else
+            seqnum_tracker->reorder_window = std::max(reorder_window, 1u);
+    }
+
+
+    bool
+    Client::seqnum_tracking_enabled()
+        const noexcept
+    {
+        return bool(seqnum_tracker);
+    }
+
+
+    void
+    Client::set_auto_resync(bool enable)
+    {
+        if (!enable) {
+            if (seqnum_tracker) {
+                seqnum_tracker->auto_resync = false;
+                seqnum_tracker->known.clear();
+                seqnum_tracker->has_view = false;
+            }
+            return;
+        }
+        // Filtered events leave holes in the seqnums, which would look like gaps.
+        if (!subsystem_filter.empty() || is_shared())
+            throw std::logic_error{"Client::set_auto_resync(): client is filtered or shared"};
+        if (!seqnum_tracker)
+            enable_seqnum_tracking();
+        seqnum_tracker->auto_resync = true;
+        if (!seqnum_tracker->has_view)
+            resync();
+    }
+
+
+    Client::SeqnumStats
+    Client::seqnum_stats()
+        const noexcept
+    {
+        if (seqnum_tracker)
+            return seqnum_tracker->counters;
+        return {};
+    }
+
+
+    void
+    Client::resync()
+    {
+        resync_view(nullptr);
+    }
+
+
+    void
+    Client::resync(std::span<const std::string> subsystems)
+    {
+        resync_view(&subsystems);
+    }
+
+
+    void
+    Client::resync_view(const std::span<const std::string>* only)
+    {
+        if (!seqnum_tracker)
+            enable_seqnum_tracking();
+        auto& tracker = *seqnum_tracker;
+        // The first call takes the whole view.
+        if (!tracker.has_view)
+            only = nullptr;
+
+        auto in_scope = [only](const char* subsystem)
+        {
+            return !only
+                || (subsystem && std::ranges::find(*only, std::string_view{subsystem}) != only->end());
+        };
+
+        // Filter entries are "subsystem" or "subsystem/devtype".
+        std::map<std::string, Device, std::less<>> current;
+        auto add_all = [this, &current](const char* subsystem,
+                                        const char* devtype)
+        {
+            for (auto& d : query(subsystem)) {
+                if (devtype) {
+                    const char* t = g_udev_device_get_devtype(d.data());
+                    if (!t || std::string_view{t} != devtype)
+                        continue;
+                }
+                if (const char* path = g_udev_device_get_sysfs_path(d.data()))
+                    current.try_emplace(path, std::move(d));
+            }
+        };
+        if (subsystem_filter.empty()) {
+            if (!only)
+                add_all(nullptr, nullptr);
+            else
+                for (auto& subsystem : *only)
+                    add_all(subsystem.c_str(), nullptr);
+        }
+        for (auto& entry : subsystem_filter) {
+            auto slash = entry.find('/');
+            std::string subsystem = entry.substr(0, slash);
+            if (!in_scope(subsystem.c_str()))
+                continue;
+            add_all(subsystem.c_str(), slash == std::string::npos ? nullptr : entry.c_str() + slash + 1);
+        }
+
+        const bool deliver = tracker.has_view;
+        std::map<std::string, detail::SeqnumTracker::Known, std::less<>> view;
+
+        for (auto& [path, device] : current) {
+            auto fp = fingerprint(device);
+            auto old = tracker.known.find(path);
+            if (deliver) {
+                if (old == tracker.known.end())
+                    post_uevent("add", device);
+                else if (old->second.fingerprint != fp)
+                    post_uevent("change", device);
+            }
+            view.emplace(path, detail::SeqnumTracker::Known{std::move(device), fp});
+        }
+
+        for (auto& [path, known] : tracker.known) {
+            if (view.contains(path))
+                continue;
+            // Devices outside the re-enumerated subsystems are kept as they were.
+            if (!in_scope(g_udev_device_get_subsystem(known.device.data())))
+                view.emplace(path, std::move(known));
+            else if (deliver)
+                post_uevent("remove", known.device);
+        }
+
+        tracker.known = std::move(view);
+        tracker.has_view = true;
+        ++tracker.counters.resyncs;
+    }
+
+
+    void
+    Client::track_uevent(const std::string& action,
+                         Device& device)
+    {
+        auto& tracker = *seqnum_tracker;
+        const auto seqnum = g_udev_device_get_seqnum(device.data());
+        tracker.note(seqnum, g_udev_device_get_subsystem(device.data()));
+        auto gaps = tracker.observe(seqnum);
+        if (tracker.auto_resync)
+            tracker.update(action, device);
+
+        std::vector<std::string> subsystems;
+        for (auto [first, last] : gaps) {
+            for (auto& s : tracker.subsystems_near(first, last))
+                if (std::ranges::find(subsystems, s) == subsystems.end())
+                    subsystems.push_back(std::move(s));
+        }
+
+        for (auto [first, last] : gaps) {
+            on_gap(first, last);
+            if (gap_callback)
+                gap_callback(first, last);
+        }
+
+        // Handlers may have disabled tracking.
+        if (gaps.empty() || !seqnum_tracker || !seqnum_tracker->auto_resync)
+            return;
+        // Nothing was seen around the gap: fall back to the whole view.
+        if (subsystems.empty())
+            resync();
+        else
+            resync(subsystems);
+    }
+
+
     /*------------------*/
     /* query operations */
     /*------------------*/
 
 
     std::vector<Device>
-    Client::query(const std::string& subsystem)
+    Client::query(zstring_view subsystem)
     {
-        const char* arg = subsystem.empty() ? nullptr : subsystem.data();
+        const char* arg = subsystem.empty() ? nullptr : subsystem.c_str();
+        GUDEVXX_PROBE(query__entry, arg);
         GList* list = g_udev_client_query_by_subsystem(raw,
                                                        arg);
         auto vec = utils::gobj_list_to_vector<GUdevDevice*>(list);
         std::vector<Device> result;
         for (auto& d : vec)
             result.push_back(Device::make_owner(d));
+        stats::count(Operation::query, stats_counters.get());
+        stats::add(&detail::StatsCounters::devices_materialized, result.size(), stats_counters.get());
+        GUDEVXX_PROBE(query__return, arg, result.size());
+        return result;
+    }
+
+
+    std::pmr::vector<Device>
+    Client::query(zstring_view subsystem,
+                  std::pmr::memory_resource* mr)
+    {
+        const char* arg = subsystem.empty() ? nullptr : subsystem.c_str();
+        GUDEVXX_PROBE(query__entry, arg);
+        GList* list = g_udev_client_query_by_subsystem(raw,
+                                                       arg);
+        auto vec = utils::gobj_list_to_vector<GUdevDevice*>(list, mr);
+        std::pmr::vector<Device> result{mr};
+        result.reserve(vec.size());
+        for (auto& d : vec)
+            result.push_back(Device::make_owner(d));
+        stats::count(Operation::query, stats_counters.get());
+        stats::add(&detail::StatsCounters::devices_materialized, result.size(), stats_counters.get());
+        GUDEVXX_PROBE(query__return, arg, result.size());
         return result;
     }
 
 
     std::optional<Device>
-    Client::get(const std::string& subsystem,
-                const std::string& name)
+    Client::get(zstring_view subsystem,
+                zstring_view name)
     {
+        GUDEVXX_PROBE(get__entry, subsystem.c_str(), name.c_str());
         auto d = g_udev_client_query_by_subsystem_and_name(raw,
                                                            subsystem.c_str(),
                                                            name.c_str());
-        if (d)
+        GUDEVXX_PROBE(get__return, subsystem.c_str(), name.c_str(), d != nullptr);
+        stats::count(Operation::get, stats_counters.get());
+        if (d) {
+            stats::add(&detail::StatsCounters::devices_materialized, 1, stats_counters.get());
             return Device::make_owner(d);
+        }
         return {};
     }
 
@@ -152,11 +906,16 @@ namespace gudev {
     Client::get(GUdevDeviceType type,
                 GUdevDeviceNumber number)
     {
+        GUDEVXX_PROBE(get_devnum__entry, int(type), number);
         auto d = g_udev_client_query_by_device_number(raw,
                                                       type,
                                                       number);
-        if (d)
+        GUDEVXX_PROBE(get_devnum__return, int(type), number, d != nullptr);
+        stats::count(Operation::get, stats_counters.get());
+        if (d) {
+            stats::add(&detail::StatsCounters::devices_materialized, 1, stats_counters.get());
             return Device::make_owner(d);
+        }
         return {};
     }
 
@@ -164,10 +923,15 @@ namespace gudev {
     std::optional<Device>
     Client::get(const std::filesystem::path &device_path)
     {
+        GUDEVXX_PROBE(get__entry, device_path.c_str(), nullptr);
         auto d = g_udev_client_query_by_device_file(raw,
                                                     device_path.c_str());
-        if (d)
+        GUDEVXX_PROBE(get__return, device_path.c_str(), nullptr, d != nullptr);
+        stats::count(Operation::get, stats_counters.get());
+        if (d) {
+            stats::add(&detail::StatsCounters::devices_materialized, 1, stats_counters.get());
             return Device::make_owner(d);
+        }
         return {};
     }
 
@@ -175,14 +939,106 @@ namespace gudev {
     std::optional<Device>
     Client::get_sysfs(const std::filesystem::path &sysfs_path)
     {
+        GUDEVXX_PROBE(get__entry, sysfs_path.c_str(), nullptr);
         auto d = g_udev_client_query_by_sysfs_path(raw,
                                                    sysfs_path.c_str());
-        if (d)
+        GUDEVXX_PROBE(get__return, sysfs_path.c_str(), nullptr, d != nullptr);
+        stats::count(Operation::get, stats_counters.get());
+        if (d) {
+            stats::add(&detail::StatsCounters::devices_materialized, 1, stats_counters.get());
             return Device::make_owner(d);
+        }
         return {};
     }
 
 
+    std::vector<std::optional<Device>>
+    Client::get_many(std::span<const std::pair<GUdevDeviceType, GUdevDeviceNumber>> numbers,
+                     unsigned num_threads)
+    {
+        std::vector<std::optional<devnum_key>> keys{numbers.begin(), numbers.end()};
+        auto result = batch_lookup(raw,
+                                   keys,
+                                   num_threads,
+                                   [](GUdevClient* c, const devnum_key& k)
+                                   {
+                                       return g_udev_client_query_by_device_number(c,
+                                                                                    k.first,
+                                                                                    k.second);
+                                   });
+        record_batch(result);
+        return result;
+    }
+
+
+    std::vector<std::optional<Device>>
+    Client::get_many(std::span<const std::filesystem::path> device_paths,
+                     unsigned num_threads)
+    {
+        // Same as g_udev_client_query_by_device_file(), but stat() only once per path.
+        std::vector<std::optional<devnum_key>> keys;
+        keys.reserve(device_paths.size());
+        for (auto& path : device_paths) {
+            struct stat st;
+            if (stat(path.c_str(), &st) == 0) {
+                if (S_ISBLK(st.st_mode)) {
+                    keys.emplace_back(std::in_place, G_UDEV_DEVICE_TYPE_BLOCK, st.st_rdev);
+                    continue;
+                }
+                if (S_ISCHR(st.st_mode)) {
+                    keys.emplace_back(std::in_place, G_UDEV_DEVICE_TYPE_CHAR, st.st_rdev);
+                    continue;
+                }
+            }
+            keys.emplace_back();
+        }
+        auto result = batch_lookup(raw,
+                                   keys,
+                                   num_threads,
+                                   [](GUdevClient* c, const devnum_key& k)
+                                   {
+                                       return g_udev_client_query_by_device_number(c,
+                                                                                    k.first,
+                                                                                    k.second);
+                                   });
+        record_batch(result);
+        return result;
+    }
+
+
+    std::vector<std::optional<Device>>
+    Client::get_sysfs_many(std::span<const std::filesystem::path> sysfs_paths,
+                           unsigned num_threads)
+    {
+        std::vector<std::optional<std::string>> keys;
+        keys.reserve(sysfs_paths.size());
+        for (auto& path : sysfs_paths)
+            keys.emplace_back(path.string());
+        auto result = batch_lookup(raw,
+                                   keys,
+                                   num_threads,
+                                   [](GUdevClient* c, const std::string& k)
+                                   {
+                                       return g_udev_client_query_by_sysfs_path(c, k.c_str());
+                                   });
+        record_batch(result);
+        return result;
+    }
+
+
+    void
+    Client::record_batch(const std::vector<std::optional<Device>>& result)
+        noexcept
+    {
+        if (!stats::active(stats_counters.get()))
+            return;
+        std::size_t n = std::ranges::count_if(result,
+                                              [](const auto& d) { return d.has_value(); });
+        stats::count(Operation::get, stats_counters.get());
+        stats::add(&detail::StatsCounters::devices_materialized, n, stats_counters.get());
+    }
+
+
     Client*
     Client::get_wrapper(GUdevClient* cli)
         noexcept
@@ -216,34 +1072,233 @@ namespace gudev {
 
 
     void
-    Client::dispatch_uevent_signal(GUdevClient* cli,
-                                   gchar*       act,
-                                   GUdevDevice* dev,
-                                   gpointer     /* data */)
+    Client::on_gap(std::uint64_t /*first*/,
+                   std::uint64_t /*last*/)
+    {}
+
+
+    void
+    Client::deliver_uevent(const std::string& action,
+                           Device& device)
+    {
+        auto local = stats_counters.get();
+        bool timed = stats::active(local);
+
+        stats::Timer on_uevent_timer{timed};
+        on_uevent(action, device);
+        if (timed)
+            stats::record(&detail::StatsCounters::handler_time, on_uevent_timer.elapsed(), local);
+
+        if (uevent_callback) {
+            stats::Timer callback_timer{timed};
+            uevent_callback(action, device);
+            if (timed)
+                stats::record(&detail::StatsCounters::handler_time, callback_timer.elapsed(), local);
+        }
+
+        if (subtree_watches && !subtree_watches->trie.empty()) {
+            stats::Timer subtree_timer{timed};
+            route_subtree(action, device);
+            if (timed)
+                stats::record(&detail::StatsCounters::handler_time, subtree_timer.elapsed(), local);
+        }
+
+        stats::add(&detail::StatsCounters::events_delivered, 1, local);
+    }
+
+
+    Client::watch_id
+    Client::watch_subtree(const std::filesystem::path& sysfs_prefix,
+                          subtree_callback callback)
+    {
+        if (!subtree_watches)
+            subtree_watches = std::make_unique<detail::SubtreeWatches>();
+        auto& sw = *subtree_watches;
+        const watch_id id = sw.next_id++;
+        std::string prefix = sysfs_prefix.lexically_normal().string();
+        sw.trie.insert(prefix, id);
+        sw.watches.emplace(id,
+                           std::pair{std::move(prefix),
+                                     std::make_shared<subtree_callback>(std::move(callback))});
+        return id;
+    }
+
+
+    bool
+    Client::unwatch_subtree(watch_id id)
+    {
+        if (!subtree_watches)
+            return false;
+        auto& sw = *subtree_watches;
+        auto it = sw.watches.find(id);
+        if (it == sw.watches.end())
+            return false;
+        sw.trie.erase(it->second.first, id);
+        sw.watches.erase(it);
+        return true;
+    }
+
+
+    std::size_t
+    Client::num_subtree_watches()
+        const noexcept
+    {
+        return subtree_watches ? subtree_watches->watches.size() : 0;
+    }
+
+
+    Client::ScopedWatch::ScopedWatch(Client& client,
+                                     const std::filesystem::path& sysfs_prefix,
+                                     subtree_callback callback) :
+        cli{client.data()}
+    {
+        if (!cli)
+            throw std::invalid_argument{"Client::ScopedWatch: null client"};
+        id = client.watch_subtree(sysfs_prefix, std::move(callback));
+        g_object_ref(cli);
+    }
+
+
+    Client::ScopedWatch::ScopedWatch(ScopedWatch&& other)
+        noexcept :
+        cli{std::exchange(other.cli, nullptr)},
+        id{other.id}
+    {}
+
+
+    Client::ScopedWatch&
+    Client::ScopedWatch::operator =(ScopedWatch&& other)
         noexcept
     {
-        try {
-            Client* client = get_wrapper(cli);
-            if (!client) {
-                g_warning("Could not find C++ wrapper for %p\n", cli);
+        if (this != &other) {
+            reset();
+            cli = std::exchange(other.cli, nullptr);
+            id = other.id;
+        }
+        return *this;
+    }
+
+
+    Client::ScopedWatch::~ScopedWatch()
+        noexcept
+    {
+        reset();
+    }
+
+
+    void
+    Client::ScopedWatch::reset()
+        noexcept
+    {
+        if (!cli)
+            return;
+        if (auto client = get_wrapper(cli))
+            client->unwatch_subtree(id);
+        g_object_unref(cli);
+        cli = nullptr;
+    }
+
+
+    Client::ScopedWatch::operator bool()
+        const noexcept
+    {
+        return cli;
+    }
+
+
+    void
+    Client::route_subtree(const std::string& action,
+                          Device& device)
+    {
+        const char* path = g_udev_device_get_sysfs_path(device.data());
+        if (!path)
+            return;
+
+        // Callbacks may add or remove watches, so look them up after the walk.
+        std::vector<watch_id> matched;
+        subtree_watches->trie.for_each_prefix(path,
+                                              [&matched](watch_id id)
+                                              {
+                                                  matched.push_back(id);
+                                              });
+
+        for (auto id : matched) {
+            if (!subtree_watches)
                 return;
+            auto it = subtree_watches->watches.find(id);
+            if (it == subtree_watches->watches.end())
+                continue;
+            auto callback = it->second.second;
+            if (*callback)
+                (*callback)(action, device);
+        }
+    }
+
+
+    bool
+    Client::receive_uevent(const char* act,
+                           GUdevDevice* dev)
+        noexcept
+    {
+        try {
+            auto local = stats_counters.get();
+            stats::add(&detail::StatsCounters::events_received, 1, local);
+            stats::Timer dispatch_timer{stats::active(local)};
+
+            // The socket filters by hashes; check the real names, like libudev does.
+            if (!subsystem_filter.empty() && !filter_accepts(subsystem_filter, dev)) {
+                stats::add(&detail::StatsCounters::events_filtered, 1, local);
+                return true;
             }
+
             std::string action = act;
             Device* device_ptr = Device::get_wrapper(dev);
-            if (device_ptr) {
-                client->on_uevent(act, *device_ptr);
-                if (client->uevent_callback)
-                    client->uevent_callback(action, *device_ptr);
-            } else {
-                auto device = Device::make_alias(dev);
-                client->on_uevent(action, device);
-                if (client->uevent_callback)
-                    client->uevent_callback(action, device);
+            std::optional<Device> alias;
+            if (!device_ptr) {
+                alias = Device::make_alias(dev);
+                device_ptr = &*alias;
             }
+            post_uevent(action, *device_ptr);
+            // Deliver the event before any synthetic ones from a resync.
+            if (seqnum_tracker)
+                track_uevent(action, *device_ptr);
+
+            if (stats::active(local))
+                stats::record(&detail::StatsCounters::dispatch_time, dispatch_timer.elapsed(), local);
+            return true;
         }
         catch (std::exception& e) {
             g_warning("Exception in signal handler: %s\n", e.what());
+            return false;
+        }
+    }
+
+
+    void
+    Client::dispatch_uevent_signal(GUdevClient* cli,
+                                   gchar*       act,
+                                   GUdevDevice* dev,
+                                   gpointer     /* data */)
+        noexcept
+    {
+        GUDEVXX_PROBE(dispatch__entry,
+                      g_udev_device_get_seqnum(dev),
+                      act,
+                      g_udev_device_get_subsystem(dev));
+        [[maybe_unused]] bool delivered = false;
+        Client* client = get_wrapper(cli);
+        if (client)
+            delivered = client->receive_uevent(act, dev);
+        else {
+            stats::add(&detail::StatsCounters::events_received);
+            stats::add(&detail::StatsCounters::events_filtered);
+            g_warning("Could not find C++ wrapper for %p\n", cli);
         }
+        GUDEVXX_PROBE(dispatch__return,
+                      g_udev_device_get_seqnum(dev),
+                      act,
+                      g_udev_device_get_subsystem(dev),
+                      delivered);
     }
 
 } // namespace gudev
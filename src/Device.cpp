@@ -5,10 +5,12 @@
  * SPDX-License-Identifier: GPL-3.0-or-later
  */
 
-#include <algorithm>
+#include <stdexcept>
 
 #include "gudevxx/Device.hpp"
 
+#include "probes.hpp"
+#include "stats.hpp"
 #include "utils.hpp"
 
 
@@ -157,6 +159,23 @@ namespace gudev {
     }
 
 
+    std::pmr::vector<std::pmr::string>
+    Device::device_symlinks(std::pmr::memory_resource* mr)
+        const
+    {
+        auto a = g_udev_device_get_device_file_symlinks(raw);
+        return utils::strv_to_vector(a, mr);
+    }
+
+
+    strv_view
+    Device::device_symlinks_view()
+        const noexcept
+    {
+        return strv_view{g_udev_device_get_device_file_symlinks(raw)};
+    }
+
+
     std::optional<Device>
     Device::parent()
         const
@@ -169,7 +188,7 @@ namespace gudev {
 
 
     std::optional<Device>
-    Device::parent(const std::string& subsystem)
+    Device::parent(zstring_view subsystem)
         const
     {
         auto p = g_udev_device_get_parent_with_subsystem(raw,
@@ -182,8 +201,8 @@ namespace gudev {
 
 
     std::optional<Device>
-    Device::parent(const std::string& subsystem,
-                   const std::string& devtype)
+    Device::parent(zstring_view subsystem,
+                   zstring_view devtype)
         const
     {
         auto p = g_udev_device_get_parent_with_subsystem(raw,
@@ -204,12 +223,28 @@ namespace gudev {
     }
 
 
+    std::pmr::vector<std::pmr::string>
+    Device::tags(std::pmr::memory_resource* mr)
+        const
+    {
+        auto t = g_udev_device_get_tags(raw);
+        return utils::strv_to_vector(t, mr);
+    }
+
+
+    strv_view
+    Device::tags_view()
+        const noexcept
+    {
+        return strv_view{g_udev_device_get_tags(raw)};
+    }
+
+
     bool
-    Device::has_tag(const std::string& tag)
+    Device::has_tag(zstring_view tag)
         const
     {
-        auto list = tags();
-        return find(list.begin(), list.end(), tag) != list.end();
+        return tags_view().contains(tag.view());
     }
 
 
@@ -234,23 +269,45 @@ namespace gudev {
     Device::property_keys()
         const
     {
+        stats::count(Operation::property);
         auto k = g_udev_device_get_property_keys(raw);
         return utils::strv_to_vector(k);
     }
 
 
+    std::pmr::vector<std::pmr::string>
+    Device::property_keys(std::pmr::memory_resource* mr)
+        const
+    {
+        stats::count(Operation::property);
+        auto k = g_udev_device_get_property_keys(raw);
+        return utils::strv_to_vector(k, mr);
+    }
+
+
+    strv_view
+    Device::property_keys_view()
+        const noexcept
+    {
+        stats::count(Operation::property);
+        return strv_view{g_udev_device_get_property_keys(raw)};
+    }
+
+
     bool
-    Device::has_property(const std::string& key)
+    Device::has_property(zstring_view key)
         const
     {
+        stats::count(Operation::property);
         return g_udev_device_has_property(raw, key.c_str());
     }
 
 
     std::optional<std::string>
-    Device::property(const std::string& key)
+    Device::property(zstring_view key)
         const
     {
+        stats::count(Operation::property);
         auto p = g_udev_device_get_property(raw, key.c_str());
         if (p)
             return p;
@@ -260,43 +317,47 @@ namespace gudev {
 
     template<>
     int
-    Device::property_as<int>(const std::string& key)
+    Device::property_as<int>(zstring_view key)
         const
     {
+        stats::count(Operation::property);
         return g_udev_device_get_property_as_int(raw, key.c_str());
     }
 
 
     template<>
     std::uint64_t
-    Device::property_as<std::uint64_t>(const std::string& key)
+    Device::property_as<std::uint64_t>(zstring_view key)
         const
     {
+        stats::count(Operation::property);
         return g_udev_device_get_property_as_uint64(raw, key.c_str());
     }
 
 
     template<>
     double
-    Device::property_as<double>(const std::string& key)
+    Device::property_as<double>(zstring_view key)
         const
     {
+        stats::count(Operation::property);
         return g_udev_device_get_property_as_double(raw, key.c_str());
     }
 
 
     template<>
     bool
-    Device::property_as<bool>(const std::string& key)
+    Device::property_as<bool>(zstring_view key)
         const
     {
+        stats::count(Operation::property);
         return g_udev_device_get_property_as_boolean(raw, key.c_str());
     }
 
 
     template<>
     std::string
-    Device::property_as<std::string>(const std::string& key)
+    Device::property_as<std::string>(zstring_view key)
         const
     {
         return property(key).value_or("");
@@ -304,36 +365,72 @@ namespace gudev {
 
 
     std::vector<std::string>
-    Device::property_tokens(const std::string& key)
+    Device::property_tokens(zstring_view key)
         const
     {
+        stats::count(Operation::property);
         auto t = g_udev_device_get_property_as_strv(raw, key.c_str());
         return utils::strv_to_vector(t);
     }
 
 
+    std::pmr::vector<std::pmr::string>
+    Device::property_tokens(zstring_view key,
+                            std::pmr::memory_resource* mr)
+        const
+    {
+        stats::count(Operation::property);
+        auto t = g_udev_device_get_property_as_strv(raw, key.c_str());
+        return utils::strv_to_vector(t, mr);
+    }
+
+
     std::vector<std::string>
     Device::sysfs_attr_keys()
         const
     {
+        stats::count(Operation::sysfs_attr);
         auto k = g_udev_device_get_sysfs_attr_keys(raw);
         return utils::strv_to_vector(k);
     }
 
 
+    std::pmr::vector<std::pmr::string>
+    Device::sysfs_attr_keys(std::pmr::memory_resource* mr)
+        const
+    {
+        stats::count(Operation::sysfs_attr);
+        auto k = g_udev_device_get_sysfs_attr_keys(raw);
+        return utils::strv_to_vector(k, mr);
+    }
+
+
+    strv_view
+    Device::sysfs_attr_keys_view()
+        const noexcept
+    {
+        stats::count(Operation::sysfs_attr);
+        return strv_view{g_udev_device_get_sysfs_attr_keys(raw)};
+    }
+
+
     bool
-    Device::has_sysfs_attr(const std::string& key)
+    Device::has_sysfs_attr(zstring_view key)
         const
     {
+        stats::count(Operation::sysfs_attr);
         return g_udev_device_has_sysfs_attr(raw, key.c_str());
     }
 
 
     std::optional<std::string>
-    Device::sysfs_attr(const std::string& key)
+    Device::sysfs_attr(zstring_view key)
         const
     {
+        stats::count(Operation::sysfs_attr);
+        GUDEVXX_PROBE(sysfs_attr__entry, g_udev_device_get_sysfs_path(raw), key.c_str());
         auto a = g_udev_device_get_sysfs_attr(raw, key.c_str());
+        GUDEVXX_PROBE(sysfs_attr__return, g_udev_device_get_sysfs_path(raw), key.c_str(), a != nullptr);
         if (a)
             return a;
         return {};
@@ -342,43 +439,47 @@ namespace gudev {
 
     template<>
     int
-    Device::sysfs_attr_as<int>(const std::string& key)
+    Device::sysfs_attr_as<int>(zstring_view key)
         const
     {
+        stats::count(Operation::sysfs_attr);
         return g_udev_device_get_sysfs_attr_as_int(raw, key.c_str());
     }
 
 
     template<>
     std::uint64_t
-    Device::sysfs_attr_as<uint64_t>(const std::string& key)
+    Device::sysfs_attr_as<uint64_t>(zstring_view key)
         const
     {
+        stats::count(Operation::sysfs_attr);
         return g_udev_device_get_sysfs_attr_as_uint64(raw, key.c_str());
     }
 
 
     template<>
     double
-    Device::sysfs_attr_as<double>(const std::string& key)
+    Device::sysfs_attr_as<double>(zstring_view key)
         const
     {
+        stats::count(Operation::sysfs_attr);
         return g_udev_device_get_sysfs_attr_as_double(raw, key.c_str());
     }
 
 
     template<>
     bool
-    Device::sysfs_attr_as<bool>(const std::string& key)
+    Device::sysfs_attr_as<bool>(zstring_view key)
         const
     {
+        stats::count(Operation::sysfs_attr);
         return g_udev_device_get_sysfs_attr_as_boolean(raw, key.c_str());
     }
 
 
     template<>
     std::string
-    Device::sysfs_attr_as<std::string>(const std::string& key)
+    Device::sysfs_attr_as<std::string>(zstring_view key)
         const
     {
         return sysfs_attr(key).value_or("");
@@ -386,14 +487,26 @@ namespace gudev {
 
 
     std::vector<std::string>
-    Device::sysfs_attr_tokens(const std::string& key)
+    Device::sysfs_attr_tokens(zstring_view key)
         const
     {
+        stats::count(Operation::sysfs_attr);
         auto t = g_udev_device_get_sysfs_attr_as_strv(raw, key.c_str());
         return utils::strv_to_vector(t);
     }
 
 
+    std::pmr::vector<std::pmr::string>
+    Device::sysfs_attr_tokens(zstring_view key,
+                              std::pmr::memory_resource* mr)
+        const
+    {
+        stats::count(Operation::sysfs_attr);
+        auto t = g_udev_device_get_sysfs_attr_as_strv(raw, key.c_str());
+        return utils::strv_to_vector(t, mr);
+    }
+
+
     Device*
     Device::get_wrapper(GUdevDevice* dev)
         noexcept
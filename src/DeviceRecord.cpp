@@ -0,0 +1,63 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <algorithm>
+
+#include "gudevxx/DeviceRecord.hpp"
+
+
+namespace gudev {
+
+    DeviceRecord::DeviceRecord(const Device& device) :
+        sysfs{device.sysfs().value_or("")},
+        subsystem{device.subsystem()},
+        devtype{device.devtype()},
+        name{device.name()},
+        driver{device.driver()},
+        device_file{device.device_file()},
+        device_number{device.device_number()},
+        seqnum{device.seqnum()},
+        type{device.type()},
+        initialized{device.is_initialized()},
+        tags{device.tags()},
+        device_symlinks{device.device_symlinks()}
+    {
+        GUdevDevice* dev = device.data();
+        if (auto keys = g_udev_device_get_property_keys(dev))
+            for (std::size_t i = 0; keys[i]; ++i)
+                if (auto val = g_udev_device_get_property(dev, keys[i]))
+                    properties.emplace(keys[i], val);
+    }
+
+
+    bool
+    DeviceRecord::has_tag(std::string_view tag)
+        const noexcept
+    {
+        return std::ranges::find(tags, tag) != tags.end();
+    }
+
+
+    bool
+    DeviceRecord::has_property(std::string_view key)
+        const
+    {
+        return properties.contains(key);
+    }
+
+
+    std::optional<std::string>
+    DeviceRecord::property(std::string_view key)
+        const
+    {
+        auto it = properties.find(key);
+        if (it != properties.end())
+            return it->second;
+        return {};
+    }
+
+} // namespace gudev
@@ -0,0 +1,356 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+#include "gudevxx/DeviceRegistry.hpp"
+
+
+namespace gudev {
+
+    namespace {
+
+        /*
+         * Epoch-based reclamation shared by all registries.
+         *
+         * Each reader thread owns a slot, where it announces the epoch it
+         * started reading in (0 when not reading). A table retired in epoch
+         * `t` can be freed once every active slot shows an epoch above `t`.
+         */
+
+        constexpr std::size_t max_reader_threads = 256;
+
+
+        struct alignas(64) ReaderSlot {
+            std::atomic_bool owned = false;
+            std::atomic_uint64_t epoch = 0;
+        };
+
+
+        std::atomic_uint64_t global_epoch = 1;
+        ReaderSlot reader_slots[max_reader_threads];
+
+
+        struct SlotOwner {
+
+            ReaderSlot* slot = nullptr;
+
+
+            SlotOwner()
+                noexcept
+            {
+                for (auto& s : reader_slots) {
+                    bool expected = false;
+                    if (s.owned.compare_exchange_strong(expected, true)) {
+                        slot = &s;
+                        break;
+                    }
+                }
+            }
+
+
+            ~SlotOwner()
+                noexcept
+            {
+                if (slot)
+                    slot->owned.store(false, std::memory_order_release);
+            }
+
+        }; // struct SlotOwner
+
+
+        /// The calling thread's slot; null if there are too many reader threads.
+        ReaderSlot*
+        this_thread_slot()
+            noexcept
+        {
+            thread_local SlotOwner owner;
+            return owner.slot;
+        }
+
+
+        std::uint64_t
+        oldest_active_epoch()
+            noexcept
+        {
+            std::uint64_t oldest = std::numeric_limits<std::uint64_t>::max();
+            for (auto& s : reader_slots)
+                if (auto e = s.epoch.load(); e)
+                    oldest = std::min(oldest, e);
+            return oldest;
+        }
+
+
+        DeviceRegistry::Snapshot::shard_type&
+        mutable_shard(DeviceRegistry::Snapshot& snap,
+                      std::size_t idx,
+                      std::shared_ptr<DeviceRegistry::Snapshot::shard_type>& copy)
+        {
+            if (!copy) {
+                auto& old = snap.shards[idx];
+                copy = old
+                    ? std::make_shared<DeviceRegistry::Snapshot::shard_type>(*old)
+                    : std::make_shared<DeviceRegistry::Snapshot::shard_type>();
+                old = copy;
+            }
+            return *copy;
+        }
+
+    } // namespace
+
+
+    struct DeviceRegistry::Holder {
+        snapshot_ptr snap;
+    };
+
+
+    DeviceRegistry::record_ptr
+    DeviceRegistry::Snapshot::find(const std::filesystem::path& sysfs_path)
+        const
+    {
+        auto& shard = shards[shard_of(sysfs_path)];
+        if (!shard)
+            return {};
+        auto it = shard->find(sysfs_path);
+        if (it != shard->end())
+            return it->second;
+        return {};
+    }
+
+
+    std::size_t
+    DeviceRegistry::Snapshot::size()
+        const noexcept
+    {
+        return count;
+    }
+
+
+    std::size_t
+    DeviceRegistry::Snapshot::shard_of(const std::filesystem::path& sysfs_path)
+        noexcept
+    {
+        return std::filesystem::hash_value(sysfs_path) % num_shards;
+    }
+
+
+    DeviceRegistry::DeviceRegistry() :
+        current{new Holder{std::make_shared<const Snapshot>()}}
+    {}
+
+
+    DeviceRegistry::~DeviceRegistry()
+        noexcept
+    {
+        watch.reset();
+        delete current.load();
+        for (auto& [holder, epoch] : retired)
+            delete holder;
+    }
+
+
+    template<typename Func>
+    auto
+    DeviceRegistry::read(Func&& func)
+        const
+    {
+        ReaderSlot* slot = this_thread_slot();
+        if (!slot) {
+            // Out of slots: reclamation only runs with the writer lock held.
+            std::lock_guard guard{writer_mutex};
+            return func(*current.load()->snap);
+        }
+
+        slot->epoch.store(global_epoch.load());
+        struct Leave {
+            ReaderSlot* slot;
+            ~Leave()
+            {
+                slot->epoch.store(0, std::memory_order_release);
+            }
+        } leave{slot};
+        return func(*current.load()->snap);
+    }
+
+
+    DeviceRegistry::snapshot_ptr
+    DeviceRegistry::snapshot()
+        const
+    {
+        ReaderSlot* slot = this_thread_slot();
+        if (!slot) {
+            std::lock_guard guard{writer_mutex};
+            return current.load()->snap;
+        }
+
+        slot->epoch.store(global_epoch.load());
+        snapshot_ptr result = current.load()->snap;
+        slot->epoch.store(0, std::memory_order_release);
+        return result;
+    }
+
+
+    DeviceRegistry::record_ptr
+    DeviceRegistry::find(const std::filesystem::path& sysfs_path)
+        const
+    {
+        return read([&sysfs_path](const Snapshot& snap)
+                    {
+                        return snap.find(sysfs_path);
+                    });
+    }
+
+
+    std::uint64_t
+    DeviceRegistry::version()
+        const
+    {
+        return read([](const Snapshot& snap)
+                    {
+                        return snap.version;
+                    });
+    }
+
+
+    void
+    DeviceRegistry::load(Client& client,
+                         zstring_view subsystem)
+    {
+        auto devices = client.query(subsystem);
+
+        std::array<std::shared_ptr<Snapshot::shard_type>, Snapshot::num_shards> shards;
+        auto next = std::make_shared<Snapshot>();
+        for (auto& dev : devices) {
+            auto rec = std::make_shared<const DeviceRecord>(dev);
+            auto idx = Snapshot::shard_of(rec->sysfs);
+            if (!shards[idx])
+                shards[idx] = std::make_shared<Snapshot::shard_type>();
+            auto path = rec->sysfs;
+            if (shards[idx]->insert_or_assign(std::move(path), std::move(rec)).second)
+                ++next->count;
+        }
+        std::ranges::copy(shards, next->shards.begin());
+
+        std::lock_guard guard{writer_mutex};
+        next->version = current.load()->snap->version + 1;
+        publish(std::move(next));
+    }
+
+
+    bool
+    DeviceRegistry::update(const std::string& action,
+                           const Device& device)
+    {
+        auto path = device.sysfs();
+        if (!path)
+            return false;
+
+        std::lock_guard guard{writer_mutex};
+        const Snapshot& prev = *current.load()->snap;
+        auto next = std::make_shared<Snapshot>(prev);
+
+        // Each shard is copied at most once, and only if it changes.
+        std::array<std::shared_ptr<Snapshot::shard_type>, Snapshot::num_shards> copies;
+        auto erase = [&](const std::filesystem::path& p)
+        {
+            auto idx = Snapshot::shard_of(p);
+            auto& old = prev.shards[idx];
+            if (!old || !old->contains(p))
+                return false;
+            mutable_shard(*next, idx, copies[idx]).erase(p);
+            --next->count;
+            return true;
+        };
+
+        bool changed = false;
+        if (action == "move")
+            if (auto old_path = device.property("DEVPATH_OLD"))
+                changed = erase("/sys" + *old_path);
+
+        if (action == "remove")
+            changed = erase(*path) || changed;
+        else {
+            auto idx = Snapshot::shard_of(*path);
+            auto rec = std::make_shared<const DeviceRecord>(device);
+            if (mutable_shard(*next, idx, copies[idx]).insert_or_assign(*path, std::move(rec)).second)
+                ++next->count;
+            changed = true;
+        }
+
+        if (!changed)
+            return false;
+
+        next->version = prev.version + 1;
+        publish(std::move(next));
+        return true;
+    }
+
+
+    void
+    DeviceRegistry::attach(Client& client,
+                           zstring_view subsystem)
+    {
+        watch.reset();
+        load(client, subsystem);
+        watch = {client,
+                 "/sys",
+                 [this, filter = std::string{subsystem.view()}](const std::string& action,
+                                                         Device& device)
+                 {
+                     // Keep the table to what load() would return.
+                     if (!filter.empty() && device.subsystem() != filter)
+                         return;
+                     update(action, device);
+                 }};
+    }
+
+
+    void
+    DeviceRegistry::detach()
+        noexcept
+    {
+        watch.reset();
+    }
+
+
+    bool
+    DeviceRegistry::attached()
+        const noexcept
+    {
+        return bool(watch);
+    }
+
+
+    void
+    DeviceRegistry::publish(std::shared_ptr<const Snapshot> next)
+    {
+        retired.reserve(retired.size() + 1);
+        const Holder* old = current.exchange(new Holder{std::move(next)});
+        retired.emplace_back(old, global_epoch.fetch_add(1));
+        reclaim();
+    }
+
+
+    void
+    DeviceRegistry::reclaim()
+        noexcept
+    {
+        // Readers that could still see a table announced an epoch no newer than its retirement.
+        const std::uint64_t oldest = oldest_active_epoch();
+        std::erase_if(retired,
+                      [oldest](const std::pair<const Holder*, std::uint64_t>& entry)
+                      {
+                          if (entry.second >= oldest)
+                              return false;
+                          delete entry.first;
+                          return true;
+                      });
+    }
+
+} // namespace gudev
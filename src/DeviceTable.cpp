@@ -0,0 +1,320 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+#include "gudevxx/DeviceTable.hpp"
+
+
+namespace gudev {
+
+    namespace {
+
+        // Drop rows from `rows` on; used to undo a partial append().
+
+        void
+        truncate(Bitmap& bitmap,
+                 std::size_t rows)
+            noexcept
+        {
+            for (std::size_t i = rows; i < bitmap.length; ++i)
+                if (!bitmap[i])
+                    --bitmap.null_count;
+            bitmap.length = std::min(bitmap.length, rows);
+            bitmap.bytes.resize((bitmap.length + 7) / 8);
+            if (bitmap.length % 8)
+                bitmap.bytes.back() &= (1u << (bitmap.length % 8)) - 1;
+        }
+
+
+        void
+        truncate(StringColumn& column,
+                 std::size_t rows)
+            noexcept
+        {
+            if (column.size() <= rows)
+                return;
+            column.data.resize(column.offsets[rows]);
+            column.offsets.resize(rows + 1);
+            truncate(column.validity, rows);
+        }
+
+
+        // Dictionary entries added by the undone row are kept; they're just unused.
+        void
+        truncate(DictionaryColumn& column,
+                 std::size_t rows)
+            noexcept
+        {
+            column.indices.resize(std::min(column.indices.size(), rows));
+            truncate(column.validity, rows);
+        }
+
+
+        template<typename T>
+        void
+        truncate(NumericColumn<T>& column,
+                 std::size_t rows)
+            noexcept
+        {
+            column.values.resize(std::min(column.values.size(), rows));
+            truncate(column.validity, rows);
+        }
+
+    } // namespace
+
+
+    void
+    Bitmap::push(bool valid)
+    {
+        if (length % 8 == 0)
+            bytes.push_back(0);
+        if (valid)
+            bytes.back() |= 1u << (length % 8);
+        else
+            ++null_count;
+        ++length;
+    }
+
+
+    void
+    StringColumn::push(std::optional<std::string_view> value)
+    {
+        if (value) {
+            if (data.size() + value->size() > std::size_t(std::numeric_limits<std::int32_t>::max()))
+                throw std::length_error{"StringColumn: more than 2 GiB of data"};
+            data.insert(data.end(), value->begin(), value->end());
+        }
+        offsets.push_back(data.size());
+        validity.push(value.has_value());
+    }
+
+
+    std::optional<std::string_view>
+    StringColumn::operator [](std::size_t i)
+        const noexcept
+    {
+        if (!validity[i])
+            return {};
+        return std::string_view{data.data() + offsets[i],
+                                std::size_t(offsets[i + 1] - offsets[i])};
+    }
+
+
+    std::optional<std::string_view>
+    DictionaryColumn::operator [](std::size_t i)
+        const noexcept
+    {
+        if (!validity[i])
+            return {};
+        return dictionary[indices[i]];
+    }
+
+
+    const DictionaryColumn*
+    DeviceTable::property(std::string_view key)
+        const noexcept
+    {
+        for (auto& [k, column] : properties)
+            if (k == key)
+                return &column;
+        return nullptr;
+    }
+
+
+    DeviceTableBuilder::DeviceTableBuilder() :
+        discover_keys{true}
+    {}
+
+
+    DeviceTableBuilder::DeviceTableBuilder(std::span<const std::string> property_keys) :
+        discover_keys{false}
+    {
+        // append() relies on column `c` holding `fixed_keys[c]`, so repeated keys are dropped.
+        for (auto& key : property_keys)
+            if (!property_index.contains(key)) {
+                fixed_keys.push_back(key);
+                property_column(key);
+            }
+    }
+
+
+    void
+    DeviceTableBuilder::push_dict(DictionaryColumn& column,
+                                  dict_map& lookup,
+                                  const char* value)
+    {
+        if (!value) {
+            column.indices.push_back(0);
+            column.validity.push(false);
+            return;
+        }
+        auto it = lookup.find(std::string_view{value});
+        if (it == lookup.end()) {
+            std::int32_t index = column.dictionary.size();
+            column.dictionary.push(value);
+            it = lookup.emplace(value, index).first;
+        }
+        column.indices.push_back(it->second);
+        column.validity.push(true);
+    }
+
+
+    std::size_t
+    DeviceTableBuilder::property_column(std::string_view key)
+    {
+        auto it = property_index.find(key);
+        if (it != property_index.end())
+            return it->second;
+
+        std::size_t index = table.properties.size();
+        auto& [name, column] = table.properties.emplace_back(std::string{key}, DictionaryColumn{});
+        property_states.push_back(PropertyState{{}, std::size_t(-1)});
+        property_index.emplace(name, index);
+
+        // Earlier rows don't have this property.
+        column.indices.resize(table.num_rows);
+        for (std::size_t i = 0; i < table.num_rows; ++i)
+            column.validity.push(false);
+        return index;
+    }
+
+
+    void
+    DeviceTableBuilder::append(const Device& device)
+    {
+        GUdevDevice* dev = device.data();
+        if (!dev)
+            throw std::invalid_argument{"DeviceTableBuilder::append(): null device"};
+
+        const std::size_t num_properties = table.properties.size();
+        try {
+            append_row(dev, device);
+        }
+        catch (...) {
+            rollback(num_properties);
+            throw;
+        }
+        ++table.num_rows;
+    }
+
+
+    void
+    DeviceTableBuilder::append_row(GUdevDevice* dev,
+                                   const Device& device)
+    {
+        const std::size_t row = table.num_rows;
+
+        auto str = [](const char* s) -> std::optional<std::string_view>
+        {
+            if (!s)
+                return {};
+            return s;
+        };
+
+        table.sysfs_path.push(str(g_udev_device_get_sysfs_path(dev)));
+        table.device_file.push(str(g_udev_device_get_device_file(dev)));
+        table.name.push(str(g_udev_device_get_name(dev)));
+        push_dict(table.subsystem, subsystem_lookup, g_udev_device_get_subsystem(dev));
+        push_dict(table.devtype, devtype_lookup, g_udev_device_get_devtype(dev));
+        push_dict(table.driver, driver_lookup, g_udev_device_get_driver(dev));
+
+        if (g_udev_device_get_device_type(dev) != G_UDEV_DEVICE_TYPE_NONE)
+            table.device_number.push(g_udev_device_get_device_number(dev));
+        else
+            table.device_number.push({});
+
+        if (discover_keys) {
+            auto keys = device.property_keys_view();
+            for (std::size_t i = 0; i < keys.size(); ++i) {
+                std::size_t c = property_column(keys[i]);
+                push_dict(table.properties[c].second,
+                          property_states[c].lookup,
+                          g_udev_device_get_property(dev, keys.c_str(i)));
+                property_states[c].last_row = row;
+            }
+        } else {
+            for (std::size_t c = 0; c < fixed_keys.size(); ++c) {
+                push_dict(table.properties[c].second,
+                          property_states[c].lookup,
+                          g_udev_device_get_property(dev, fixed_keys[c].c_str()));
+                property_states[c].last_row = row;
+            }
+        }
+
+        // Properties this device doesn't have.
+        for (std::size_t c = 0; c < property_states.size(); ++c)
+            if (property_states[c].last_row != row) {
+                table.properties[c].second.indices.push_back(0);
+                table.properties[c].second.validity.push(false);
+            }
+    }
+
+
+    void
+    DeviceTableBuilder::rollback(std::size_t num_properties)
+        noexcept
+    {
+        const std::size_t rows = table.num_rows;
+        truncate(table.sysfs_path, rows);
+        truncate(table.device_file, rows);
+        truncate(table.name, rows);
+        truncate(table.subsystem, rows);
+        truncate(table.devtype, rows);
+        truncate(table.driver, rows);
+        truncate(table.device_number, rows);
+
+        // Forget the columns first seen in the undone row.
+        while (table.properties.size() > num_properties) {
+            property_index.erase(table.properties.back().first);
+            table.properties.pop_back();
+        }
+        property_states.resize(std::min(property_states.size(), num_properties),
+                               PropertyState{{}, std::size_t(-1)});
+        for (auto& [key, column] : table.properties)
+            truncate(column, rows);
+        // The undone row may have marked properties as present.
+        for (auto& state : property_states)
+            if (state.last_row != std::size_t(-1) && state.last_row >= rows)
+                state.last_row = std::size_t(-1);
+    }
+
+
+    void
+    DeviceTableBuilder::append(std::span<const Device> devices)
+    {
+        for (auto& d : devices)
+            append(d);
+    }
+
+
+    std::size_t
+    DeviceTableBuilder::size()
+        const noexcept
+    {
+        return table.num_rows;
+    }
+
+
+    DeviceTable
+    DeviceTableBuilder::finish()
+    {
+        DeviceTable result = std::move(table);
+        table = {};
+        subsystem_lookup.clear();
+        devtype_lookup.clear();
+        driver_lookup.clear();
+        property_states.clear();
+        property_index.clear();
+        for (auto& key : fixed_keys)
+            property_column(key);
+        return result;
+    }
+
+} // namespace gudev
@@ -5,13 +5,211 @@
  * SPDX-License-Identifier: GPL-3.0-or-later
  */
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <utility>
+
 #include "gudevxx/Enumerator.hpp"
 
+#include "gudevxx/ParallelEnumerator.hpp"
+
+#include "probes.hpp"
+#include "stats.hpp"
 #include "utils.hpp"
 
 
 namespace gudev {
 
+    namespace {
+
+        struct AsyncState {
+
+            MatchRules rules;
+            Enumerator::chunk_callback on_chunk;
+            Enumerator::done_callback on_done;
+            AsyncEnumerateOptions options;
+            std::stop_token stop;
+            GCancellable* cancellable = nullptr;
+            GMainContext* context = nullptr;
+
+            std::mutex seen_mutex;
+            std::set<std::filesystem::path> seen;
+
+
+            ~AsyncState()
+                noexcept
+            {
+                if (cancellable)
+                    g_object_unref(cancellable);
+                if (context)
+                    g_main_context_unref(context);
+            }
+
+
+            bool
+            cancelled()
+                const noexcept
+            {
+                return stop.stop_requested()
+                    || (cancellable && g_cancellable_is_cancelled(cancellable));
+            }
+
+        };
+
+
+        /*
+         * Run `func` on the caller's context. An idle source is used instead of
+         * g_main_context_invoke(), which would run `func` right here if this
+         * thread manages to acquire the context.
+         */
+        template<typename Func>
+        void
+        post(GMainContext* context,
+             Func func)
+        {
+            GSource* source = g_idle_source_new();
+            g_source_set_priority(source, G_PRIORITY_DEFAULT);
+            g_source_set_callback(source,
+                                  [](gpointer data) -> gboolean
+                                  {
+                                      (*static_cast<Func*>(data))();
+                                      return G_SOURCE_REMOVE;
+                                  },
+                                  new Func{std::move(func)},
+                                  [](gpointer data)
+                                  {
+                                      delete static_cast<Func*>(data);
+                                  });
+            g_source_attach(source, context);
+            g_source_unref(source);
+        }
+
+
+        void
+        deliver(const std::shared_ptr<AsyncState>& state,
+                std::vector<Device> devices)
+        {
+            if (!state->rules.sysfs_paths.empty()) {
+                std::lock_guard guard{state->seen_mutex};
+                for (auto& dev : devices)
+                    if (auto path = dev.sysfs())
+                        state->seen.insert(std::move(*path));
+            }
+
+            const std::size_t chunk_size = std::max<std::size_t>(state->options.chunk_size, 1);
+            for (std::size_t first = 0; first < devices.size(); first += chunk_size) {
+                const std::size_t last = std::min(first + chunk_size, devices.size());
+                std::vector<Device> chunk;
+                chunk.reserve(last - first);
+                for (std::size_t i = first; i < last; ++i)
+                    chunk.push_back(std::move(devices[i]));
+                post(state->context,
+                     [state, chunk = std::move(chunk)]() mutable
+                     {
+                         if (state->on_chunk && !state->cancelled())
+                             state->on_chunk(std::move(chunk));
+                     });
+            }
+        }
+
+
+        void
+        run_async(std::shared_ptr<AsyncState> state)
+        {
+            std::exception_ptr error;
+
+            try {
+                const auto tasks = ParallelEnumerator{state->rules}.subsystems();
+
+                MatchRules task_rules = state->rules;
+                task_rules.subsystems.clear();
+                task_rules.nomatch_subsystems.clear();
+                task_rules.sysfs_paths.clear();
+
+                unsigned workers = state->options.num_threads;
+                if (!workers)
+                    workers = std::thread::hardware_concurrency();
+                workers = std::clamp<unsigned>(workers, 1, std::max<std::size_t>(tasks.size(), 1));
+
+                std::atomic_size_t next_task = 0;
+                std::vector<std::exception_ptr> errors(workers);
+
+                auto work = [&](unsigned id)
+                {
+                    try {
+                        Client client;
+                        for (std::size_t i = next_task++;
+                             i < tasks.size() && !state->cancelled();
+                             i = next_task++) {
+                            Enumerator etor{client};
+                            task_rules.apply(etor);
+                            etor.match_subsystem(tasks[i]);
+                            deliver(state, etor.execute());
+                        }
+                    }
+                    catch (...) {
+                        errors[id] = std::current_exception();
+                        next_task = tasks.size();
+                    }
+                };
+
+                {
+                    std::vector<std::jthread> threads;
+                    for (unsigned id = 1; id < workers; ++id)
+                        threads.emplace_back(work, id);
+                    work(0);
+                }
+
+                for (auto& e : errors)
+                    if (e)
+                        std::rethrow_exception(e);
+
+                if (!state->rules.sysfs_paths.empty() && !state->cancelled()) {
+                    Client client;
+                    std::vector<Device> extra;
+                    for (auto& path : state->rules.sysfs_paths) {
+                        if (state->seen.contains(path))
+                            continue;
+                        if (auto dev = client.get_sysfs(path)) {
+                            state->seen.insert(path);
+                            extra.push_back(std::move(*dev));
+                        }
+                    }
+                    deliver(state, std::move(extra));
+                }
+            }
+            catch (...) {
+                error = std::current_exception();
+            }
+
+            // Sources of equal priority are dispatched in the order they were
+            // attached, so this runs after every chunk. The callbacks are
+            // released here, on the caller's thread.
+            post(state->context,
+                 [state, error]()
+                 {
+                     auto on_chunk = std::move(state->on_chunk);
+                     auto on_done = std::move(state->on_done);
+                     if (on_done)
+                         on_done(state->cancelled(), error);
+                 });
+        }
+
+
+        void
+        start_async(std::shared_ptr<AsyncState> state)
+        {
+            state->context = g_main_context_ref_thread_default();
+            std::thread{run_async, std::move(state)}.detach();
+        }
+
+    } // namespace
+
+
     Enumerator::Enumerator(std::nullptr_t)
         noexcept
     {}
@@ -31,6 +229,7 @@ namespace gudev {
             throw std::runtime_error{"Could not create new GUdevEnumerator"};
         destroy();
         acquire(ptr);
+        recorded = {};
     }
 
 
@@ -44,60 +243,67 @@ namespace gudev {
 
 
     Enumerator&
-    Enumerator::match_subsystem(const std::string& subsystem)
+    Enumerator::match_subsystem(zstring_view subsystem)
     {
-        g_udev_enumerator_add_match_subsystem(raw, subsystem.data());
+        g_udev_enumerator_add_match_subsystem(raw, subsystem.c_str());
+        recorded.match_subsystem(subsystem);
         return *this;
     }
 
 
     Enumerator&
-    Enumerator::nomatch_subsystem(const std::string& subsystem)
+    Enumerator::nomatch_subsystem(zstring_view subsystem)
     {
-        g_udev_enumerator_add_nomatch_subsystem(raw, subsystem.data());
+        g_udev_enumerator_add_nomatch_subsystem(raw, subsystem.c_str());
+        recorded.nomatch_subsystem(subsystem);
         return *this;
     }
 
 
     Enumerator&
-    Enumerator::match_sysfs_attr(const std::string& key,
-                                 const std::string& val)
+    Enumerator::match_sysfs_attr(zstring_view key,
+                                 zstring_view val)
     {
-        g_udev_enumerator_add_match_sysfs_attr(raw, key.data(), val.data());
+        g_udev_enumerator_add_match_sysfs_attr(raw, key.c_str(), val.c_str());
+        recorded.match_sysfs_attr(key, val);
         return *this;
     }
 
 
     Enumerator&
-    Enumerator::nomatch_sysfs_attr(const std::string& key,
-                                   const std::string& val)
+    Enumerator::nomatch_sysfs_attr(zstring_view key,
+                                   zstring_view val)
     {
-        g_udev_enumerator_add_nomatch_sysfs_attr(raw, key.data(), val.data());
+        g_udev_enumerator_add_nomatch_sysfs_attr(raw, key.c_str(), val.c_str());
+        recorded.nomatch_sysfs_attr(key, val);
         return *this;
     }
 
 
     Enumerator&
-    Enumerator::match_property(const std::string& key,
-                               const std::string& val)
+    Enumerator::match_property(zstring_view key,
+                               zstring_view val)
     {
-        g_udev_enumerator_add_match_property(raw, key.data(), val.data());
+        g_udev_enumerator_add_match_property(raw, key.c_str(), val.c_str());
+        recorded.match_property(key, val);
         return *this;
     }
 
 
     Enumerator&
-    Enumerator::match_name(const std::string& name)
+    Enumerator::match_name(zstring_view name)
     {
-        g_udev_enumerator_add_match_name(raw, name.data());
+        g_udev_enumerator_add_match_name(raw, name.c_str());
+        recorded.match_name(name);
         return *this;
     }
 
 
     Enumerator&
-    Enumerator::match_tag(const std::string& tag)
+    Enumerator::match_tag(zstring_view tag)
     {
-        g_udev_enumerator_add_match_tag(raw, tag.data());
+        g_udev_enumerator_add_match_tag(raw, tag.c_str());
+        recorded.match_tag(tag);
         return *this;
     }
 
@@ -106,6 +312,7 @@ namespace gudev {
     Enumerator::match_initialized()
     {
         g_udev_enumerator_add_match_is_initialized(raw);
+        recorded.match_initialized();
         return *this;
     }
 
@@ -114,6 +321,7 @@ namespace gudev {
     Enumerator::add_sysfs_path(const std::filesystem::path& sysfs_path)
     {
         g_udev_enumerator_add_sysfs_path(raw, sysfs_path.c_str());
+        recorded.add_sysfs_path(sysfs_path);
         return *this;
     }
 
@@ -121,12 +329,76 @@ namespace gudev {
     std::vector<Device>
     Enumerator::execute()
     {
+        GUDEVXX_PROBE(enumerate__entry);
         GList* list = g_udev_enumerator_execute(raw);
         auto devs = utils::gobj_list_to_vector<GUdevDevice*>(list);
         std::vector<Device> result;
         for (auto& d : devs)
             result.push_back(Device::make_owner(d));
+        stats::count(Operation::enumerate);
+        stats::add(&detail::StatsCounters::devices_materialized, result.size());
+        GUDEVXX_PROBE(enumerate__return, result.size());
         return result;
     }
 
+
+    std::pmr::vector<Device>
+    Enumerator::execute(std::pmr::memory_resource* mr)
+    {
+        GUDEVXX_PROBE(enumerate__entry);
+        GList* list = g_udev_enumerator_execute(raw);
+        auto devs = utils::gobj_list_to_vector<GUdevDevice*>(list, mr);
+        std::pmr::vector<Device> result{mr};
+        result.reserve(devs.size());
+        for (auto& d : devs)
+            result.push_back(Device::make_owner(d));
+        stats::count(Operation::enumerate);
+        stats::add(&detail::StatsCounters::devices_materialized, result.size());
+        GUDEVXX_PROBE(enumerate__return, result.size());
+        return result;
+    }
+
+
+    void
+    Enumerator::execute_async(chunk_callback on_chunk,
+                              done_callback on_done,
+                              std::stop_token stop,
+                              const AsyncEnumerateOptions& options)
+        const
+    {
+        auto state = std::make_shared<AsyncState>();
+        state->rules = recorded;
+        state->on_chunk = std::move(on_chunk);
+        state->on_done = std::move(on_done);
+        state->options = options;
+        state->stop = std::move(stop);
+        start_async(std::move(state));
+    }
+
+
+    void
+    Enumerator::execute_async(chunk_callback on_chunk,
+                              done_callback on_done,
+                              GCancellable* cancellable,
+                              const AsyncEnumerateOptions& options)
+        const
+    {
+        auto state = std::make_shared<AsyncState>();
+        state->rules = recorded;
+        state->on_chunk = std::move(on_chunk);
+        state->on_done = std::move(on_done);
+        state->options = options;
+        if (cancellable)
+            state->cancellable = G_CANCELLABLE(g_object_ref(cancellable));
+        start_async(std::move(state));
+    }
+
+
+    const MatchRules&
+    Enumerator::rules()
+        const noexcept
+    {
+        return recorded;
+    }
+
 } // namespace gudev
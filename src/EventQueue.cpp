@@ -0,0 +1,212 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <algorithm>
+#include <utility>
+
+#include "gudevxx/EventQueue.hpp"
+
+
+namespace gudev {
+
+    EventQueue::EventQueue() :
+        EventQueue{Options{}}
+    {}
+
+
+    EventQueue::EventQueue(const Options& options) :
+        opts{options}
+    {
+        opts.capacity = std::max<std::size_t>(opts.capacity, 1);
+        if (!opts.high_watermark)
+            opts.high_watermark = std::max<std::size_t>(opts.capacity * 3 / 4, 1);
+        opts.high_watermark = std::min(opts.high_watermark, opts.capacity);
+        if (!opts.low_watermark)
+            opts.low_watermark = opts.capacity / 4;
+        opts.low_watermark = std::min(opts.low_watermark, opts.high_watermark - 1);
+        opts.batch_size = std::max<std::size_t>(opts.batch_size, 1);
+    }
+
+
+    void
+    EventQueue::push(const std::string& action,
+                     Device& device,
+                     const handler_type& handler)
+    {
+        std::string path;
+        if (opts.policy == Policy::coalesce) {
+            const char* p = g_udev_device_get_sysfs_path(device.data());
+            path = p ? p : "";
+            if (!path.empty() && coalesce(action, device, path))
+                return;
+        }
+
+        if (live >= opts.capacity) {
+            switch (opts.policy) {
+                case Policy::block:
+                    ++stats.blocked;
+                    // The options keep low_watermark < capacity; clamp anyway,
+                    // so at least one slot is freed.
+                    drain(handler, live > opts.low_watermark ? live - opts.low_watermark : 1);
+                    break;
+                case Policy::drop_newest:
+                    ++stats.dropped;
+                    return;
+                case Policy::drop_oldest:
+                case Policy::coalesce:
+                    drop_oldest();
+                    break;
+            }
+        }
+
+        if (!path.empty())
+            latest.insert_or_assign(path, base + entries.size());
+        entries.push_back(Entry{action, Device::make_alias(device.data()), std::move(path)});
+        ++live;
+        ++stats.enqueued;
+        stats.max_depth = std::max(stats.max_depth, live);
+
+        if (!above_high && live >= opts.high_watermark) {
+            above_high = true;
+            ++stats.high_watermark_hits;
+            if (high_watermark_callback)
+                high_watermark_callback(live);
+        }
+    }
+
+
+    bool
+    EventQueue::coalesce(const std::string& action,
+                         Device& device,
+                         const std::string& path)
+    {
+        auto it = latest.find(path);
+        if (it == latest.end())
+            return false;
+        Entry& old = entries[it->second - base];
+
+        // A removal followed by anything else must be seen as is.
+        if (old.action == "remove")
+            return false;
+
+        if (action == "change") {
+            // "add" then "change" is still an "add", with the latest state.
+            if (old.action != "add" && old.action != "change")
+                return false;
+            old.device = Device::make_alias(device.data());
+        } else if (action == "remove") {
+            if (old.action == "add") {
+                // The device came and went: nothing to report.
+                old.valid = false;
+                --live;
+                latest.erase(it);
+                ++stats.coalesced;
+                check_low_watermark();
+                return true;
+            }
+            if (old.action != "change")
+                return false;
+            old.action = action;
+            old.device = Device::make_alias(device.data());
+        } else
+            return false;
+
+        ++stats.coalesced;
+        return true;
+    }
+
+
+    EventQueue::Entry
+    EventQueue::pop_front()
+    {
+        Entry front = std::move(entries.front());
+        entries.pop_front();
+        if (!front.path.empty()) {
+            auto it = latest.find(front.path);
+            if (it != latest.end() && it->second == base)
+                latest.erase(it);
+        }
+        ++base;
+        return front;
+    }
+
+
+    void
+    EventQueue::drop_oldest()
+    {
+        while (!entries.empty()) {
+            if (pop_front().valid) {
+                --live;
+                ++stats.dropped;
+                return;
+            }
+        }
+    }
+
+
+    void
+    EventQueue::check_low_watermark()
+    {
+        if (above_high && live <= opts.low_watermark) {
+            above_high = false;
+            if (low_watermark_callback)
+                low_watermark_callback(live);
+        }
+    }
+
+
+    std::size_t
+    EventQueue::drain(const handler_type& handler,
+                      std::size_t max)
+    {
+        std::size_t n = 0;
+        while (n < max && !entries.empty()) {
+            Entry entry = pop_front();
+            if (!entry.valid)
+                continue;
+            --live;
+            ++n;
+            ++stats.delivered;
+            check_low_watermark();
+            handler(entry.action, entry.device);
+        }
+        return n;
+    }
+
+
+    std::size_t
+    EventQueue::size()
+        const noexcept
+    {
+        return live;
+    }
+
+
+    bool
+    EventQueue::empty()
+        const noexcept
+    {
+        return live == 0;
+    }
+
+
+    const EventQueue::Options&
+    EventQueue::options()
+        const noexcept
+    {
+        return opts;
+    }
+
+
+    EventQueue::Counters
+    EventQueue::counters()
+        const noexcept
+    {
+        return stats;
+    }
+
+} // namespace gudev
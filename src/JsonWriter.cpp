@@ -0,0 +1,338 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <cerrno>
+#include <charconv>
+#include <system_error>
+#include <utility>
+
+#include <unistd.h>
+
+#include "gudevxx/JsonWriter.hpp"
+
+#include "gudevxx/NetlinkMonitor.hpp"
+
+
+namespace gudev {
+
+    namespace {
+
+        constexpr char hex_digits[] = "0123456789abcdef";
+
+
+        bool
+        needs_escape(unsigned char c)
+            noexcept
+        {
+            return c < 0x20 || c == '"' || c == '\\' || c >= 0x80;
+        }
+
+
+        // Length of a valid UTF-8 sequence starting at `s`, or 0.
+        std::size_t
+        utf8_length(std::string_view s)
+            noexcept
+        {
+            auto b = [&s](std::size_t i) -> unsigned
+            {
+                return static_cast<unsigned char>(s[i]);
+            };
+            auto cont = [&](std::size_t i)
+            {
+                return i < s.size() && (b(i) & 0xc0) == 0x80;
+            };
+
+            unsigned c = b(0);
+            if (c >= 0xc2 && c <= 0xdf)
+                return cont(1) ? 2 : 0;
+            if (c >= 0xe0 && c <= 0xef) {
+                if (!cont(1) || !cont(2))
+                    return 0;
+                // Reject overlong forms and surrogates.
+                if ((c == 0xe0 && b(1) < 0xa0) || (c == 0xed && b(1) > 0x9f))
+                    return 0;
+                return 3;
+            }
+            if (c >= 0xf0 && c <= 0xf4) {
+                if (!cont(1) || !cont(2) || !cont(3))
+                    return 0;
+                if ((c == 0xf0 && b(1) < 0x90) || (c == 0xf4 && b(1) > 0x8f))
+                    return 0;
+                return 4;
+            }
+            return 0;
+        }
+
+    } // namespace
+
+
+    JsonWriter::JsonWriter(std::size_t reserve)
+    {
+        buf.reserve(reserve);
+    }
+
+
+    JsonWriter::JsonWriter(std::string&& buffer)
+        noexcept :
+        buf{std::move(buffer)}
+    {}
+
+
+    JsonWriter&
+    JsonWriter::write(const Uevent& event)
+    {
+        begin_object();
+        member("action", event.action);
+        member("devpath", event.devpath);
+        member("subsystem", event.subsystem);
+        if (!event.devtype.empty())
+            member("devtype", event.devtype);
+        if (event.seqnum)
+            member("seqnum", event.seqnum);
+        member("from_kernel", event.from_kernel);
+
+        key("properties");
+        buf += '{';
+        bool first = true;
+        event.for_each_property([this, &first](std::string_view k,
+                                               std::string_view v)
+        {
+            if (!first)
+                buf += ',';
+            first = false;
+            append_string(k);
+            buf += ':';
+            append_string(v);
+        });
+        buf += '}';
+
+        end_object();
+        return *this;
+    }
+
+
+    std::string_view
+    JsonWriter::view()
+        const noexcept
+    {
+        return buf;
+    }
+
+
+    std::size_t
+    JsonWriter::size()
+        const noexcept
+    {
+        return buf.size();
+    }
+
+
+    void
+    JsonWriter::clear()
+        noexcept
+    {
+        buf.clear();
+    }
+
+
+    std::string
+    JsonWriter::release()
+        noexcept
+    {
+        return std::exchange(buf, {});
+    }
+
+
+    void
+    JsonWriter::flush(int fd)
+    {
+        std::string_view rest = buf;
+        while (!rest.empty()) {
+            ssize_t n = ::write(fd, rest.data(), rest.size());
+            if (n < 0) {
+                if (errno == EINTR)
+                    continue;
+                throw std::system_error{errno, std::system_category(), "write()"};
+            }
+            rest.remove_prefix(n);
+        }
+        buf.clear();
+    }
+
+
+    void
+    JsonWriter::append_string(std::string_view str)
+    {
+        buf += '"';
+        while (!str.empty()) {
+            // Copy the longest run that needs no escaping at once.
+            std::size_t run = 0;
+            while (run < str.size() && !needs_escape(str[run]))
+                ++run;
+            buf.append(str.data(), run);
+            str.remove_prefix(run);
+            if (str.empty())
+                break;
+
+            unsigned char c = str.front();
+            if (c >= 0x80) {
+                if (std::size_t len = utf8_length(str)) {
+                    buf.append(str.data(), len);
+                    str.remove_prefix(len);
+                } else {
+                    buf += "\\ufffd";
+                    str.remove_prefix(1);
+                }
+                continue;
+            }
+
+            switch (c) {
+                case '"':  buf += "\\\""; break;
+                case '\\': buf += "\\\\"; break;
+                case '\b': buf += "\\b";  break;
+                case '\f': buf += "\\f";  break;
+                case '\n': buf += "\\n";  break;
+                case '\r': buf += "\\r";  break;
+                case '\t': buf += "\\t";  break;
+                default:
+                    buf += "\\u00";
+                    buf += hex_digits[c >> 4];
+                    buf += hex_digits[c & 0xf];
+            }
+            str.remove_prefix(1);
+        }
+        buf += '"';
+    }
+
+
+    void
+    JsonWriter::begin_object()
+    {
+        buf += '{';
+        first_member = true;
+    }
+
+
+    void
+    JsonWriter::end_object()
+    {
+        buf += "}\n";
+    }
+
+
+    void
+    JsonWriter::key(std::string_view k)
+    {
+        if (!first_member)
+            buf += ',';
+        first_member = false;
+        // Keys are literals that never need escaping.
+        buf += '"';
+        buf += k;
+        buf += "\":";
+    }
+
+
+    void
+    JsonWriter::member(std::string_view k,
+                       const char* value)
+    {
+        if (!value)
+            return;
+        member(k, std::string_view{value});
+    }
+
+
+    void
+    JsonWriter::member(std::string_view k,
+                       std::string_view value)
+    {
+        key(k);
+        append_string(value);
+    }
+
+
+    void
+    JsonWriter::member(std::string_view k,
+                       std::uint64_t value)
+    {
+        key(k);
+        char digits[20];
+        auto [end, ec] = std::to_chars(digits, digits + sizeof digits, value);
+        buf.append(digits, end);
+    }
+
+
+    void
+    JsonWriter::member(std::string_view k,
+                       bool value)
+    {
+        key(k);
+        buf += value ? "true" : "false";
+    }
+
+
+    void
+    JsonWriter::member(std::string_view k,
+                       strv_view values)
+    {
+        if (values.empty())
+            return;
+        key(k);
+        buf += '[';
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            if (i)
+                buf += ',';
+            append_string(values[i]);
+        }
+        buf += ']';
+    }
+
+
+    void
+    JsonWriter::properties_member(GUdevDevice* dev,
+                                  strv_view keys)
+    {
+        if (keys.empty())
+            return;
+        key("properties");
+        buf += '{';
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            if (i)
+                buf += ',';
+            append_string(keys[i]);
+            buf += ':';
+            const char* val = g_udev_device_get_property(dev, keys.c_str(i));
+            append_string(val ? val : "");
+        }
+        buf += '}';
+    }
+
+
+    void
+    JsonWriter::sysfs_attrs_member(GUdevDevice* dev,
+                                   strv_view keys)
+    {
+        if (keys.empty())
+            return;
+        key("sysfs_attrs");
+        buf += '{';
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            if (i)
+                buf += ',';
+            append_string(keys[i]);
+            buf += ':';
+            // Unreadable attributes are null.
+            if (const char* val = g_udev_device_get_sysfs_attr(dev, keys.c_str(i)))
+                append_string(val);
+            else
+                buf += "null";
+        }
+        buf += '}';
+    }
+
+} // namespace gudev
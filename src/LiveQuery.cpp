@@ -0,0 +1,174 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <utility>
+
+#include "gudevxx/LiveQuery.hpp"
+
+#include "gudevxx/Enumerator.hpp"
+
+
+namespace gudev {
+
+    LiveQuery::LiveQuery(MatchRules rules) :
+        match_rules{std::move(rules)}
+    {}
+
+
+    LiveQuery::LiveQuery(MatchRules rules,
+                         Client& client) :
+        LiveQuery{std::move(rules)}
+    {
+        attach(client);
+    }
+
+
+    LiveQuery::~LiveQuery()
+        noexcept = default;
+
+
+    const MatchRules&
+    LiveQuery::rules()
+        const noexcept
+    {
+        return match_rules;
+    }
+
+
+    void
+    LiveQuery::refresh(Client& client)
+    {
+        Enumerator etor{client};
+        match_rules.apply(etor);
+        map_type new_result;
+        for (auto& dev : etor.execute()) {
+            auto path = dev.sysfs();
+            if (path)
+                new_result.insert_or_assign(std::move(*path), std::move(dev));
+        }
+        result = std::move(new_result);
+    }
+
+
+    void
+    LiveQuery::attach(Client& client)
+    {
+        watch.reset();
+        refresh(client);
+        watch = {client,
+                 "/sys",
+                 [this](const std::string& action, Device& device)
+                 {
+                     update(action, device);
+                 }};
+    }
+
+
+    void
+    LiveQuery::detach()
+        noexcept
+    {
+        watch.reset();
+    }
+
+
+    bool
+    LiveQuery::attached()
+        const noexcept
+    {
+        return bool(watch);
+    }
+
+
+    bool
+    LiveQuery::update(const std::string& action,
+                      Device& device)
+    {
+        auto path = device.sysfs();
+        if (!path)
+            return false;
+
+        if (action == "remove")
+            return remove(*path);
+
+        bool changed = false;
+        if (action == "move") {
+            // The old location is only known through the event properties.
+            if (auto old_path = device.property("DEVPATH_OLD"))
+                changed = remove("/sys" + *old_path);
+        }
+
+        if (!match_rules.matches(device))
+            return remove(*path) || changed;
+
+        auto [it, inserted] = result.insert_or_assign(*path, Device::make_alias(device.data()));
+        if (inserted) {
+            on_added(it->second);
+            if (added_callback)
+                added_callback(it->second);
+        } else {
+            on_changed(it->second);
+            if (changed_callback)
+                changed_callback(it->second);
+        }
+        return true;
+    }
+
+
+    const LiveQuery::map_type&
+    LiveQuery::devices()
+        const noexcept
+    {
+        return result;
+    }
+
+
+    std::size_t
+    LiveQuery::size()
+        const noexcept
+    {
+        return result.size();
+    }
+
+
+    bool
+    LiveQuery::contains(const std::filesystem::path& sysfs_path)
+        const
+    {
+        return result.contains(sysfs_path);
+    }
+
+
+    void
+    LiveQuery::on_added(Device& /*device*/)
+    {}
+
+
+    void
+    LiveQuery::on_removed(Device& /*device*/)
+    {}
+
+
+    void
+    LiveQuery::on_changed(Device& /*device*/)
+    {}
+
+
+    bool
+    LiveQuery::remove(const std::filesystem::path& sysfs_path)
+    {
+        auto it = result.find(sysfs_path);
+        if (it == result.end())
+            return false;
+        on_removed(it->second);
+        if (removed_callback)
+            removed_callback(it->second);
+        result.erase(it);
+        return true;
+    }
+
+} // namespace gudev
@@ -0,0 +1,214 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <algorithm>
+
+#include <fnmatch.h>
+
+#include "gudevxx/MatchRules.hpp"
+
+#include "gudevxx/Enumerator.hpp"
+
+
+namespace gudev {
+
+    namespace {
+
+        // Same as libudev: match patterns are shell globs.
+        bool
+        glob_match(const std::string& pattern,
+                   const char* value)
+        {
+            return value && fnmatch(pattern.c_str(), value, 0) == 0;
+        }
+
+
+        bool
+        glob_match_any(const std::vector<std::string>& patterns,
+                       const char* value)
+        {
+            return std::ranges::any_of(patterns,
+                                       [value](const std::string& p)
+                                       {
+                                           return glob_match(p, value);
+                                       });
+        }
+
+
+        bool
+        sysfs_attr_matches(GUdevDevice* dev,
+                           const std::pair<std::string, std::string>& rule)
+        {
+            auto val = g_udev_device_get_sysfs_attr(dev, rule.first.c_str());
+            return glob_match(rule.second, val);
+        }
+
+
+        bool
+        property_matches(GUdevDevice* dev,
+                         const std::pair<std::string, std::string>& rule)
+        {
+            auto val = g_udev_device_get_property(dev, rule.first.c_str());
+            return glob_match(rule.second, val);
+        }
+
+    } // namespace
+
+
+    MatchRules&
+    MatchRules::match_subsystem(zstring_view subsystem)
+    {
+        subsystems.emplace_back(subsystem.c_str());
+        return *this;
+    }
+
+
+    MatchRules&
+    MatchRules::nomatch_subsystem(zstring_view subsystem)
+    {
+        nomatch_subsystems.emplace_back(subsystem.c_str());
+        return *this;
+    }
+
+
+    MatchRules&
+    MatchRules::match_sysfs_attr(zstring_view key,
+                                 zstring_view val)
+    {
+        sysfs_attrs.emplace_back(key.c_str(), val.c_str());
+        return *this;
+    }
+
+
+    MatchRules&
+    MatchRules::nomatch_sysfs_attr(zstring_view key,
+                                   zstring_view val)
+    {
+        nomatch_sysfs_attrs.emplace_back(key.c_str(), val.c_str());
+        return *this;
+    }
+
+
+    MatchRules&
+    MatchRules::match_property(zstring_view key,
+                               zstring_view val)
+    {
+        properties.emplace_back(key.c_str(), val.c_str());
+        return *this;
+    }
+
+
+    MatchRules&
+    MatchRules::match_name(zstring_view name)
+    {
+        names.emplace_back(name.c_str());
+        return *this;
+    }
+
+
+    MatchRules&
+    MatchRules::match_tag(zstring_view tag)
+    {
+        tags.emplace_back(tag.c_str());
+        return *this;
+    }
+
+
+    MatchRules&
+    MatchRules::match_initialized()
+    {
+        initialized = true;
+        return *this;
+    }
+
+
+    MatchRules&
+    MatchRules::add_sysfs_path(const std::filesystem::path& sysfs_path)
+    {
+        sysfs_paths.push_back(sysfs_path);
+        return *this;
+    }
+
+
+    void
+    MatchRules::apply(Enumerator& etor)
+        const
+    {
+        for (auto& s : subsystems)
+            etor.match_subsystem(s);
+        for (auto& s : nomatch_subsystems)
+            etor.nomatch_subsystem(s);
+        for (auto& [k, v] : sysfs_attrs)
+            etor.match_sysfs_attr(k, v);
+        for (auto& [k, v] : nomatch_sysfs_attrs)
+            etor.nomatch_sysfs_attr(k, v);
+        for (auto& [k, v] : properties)
+            etor.match_property(k, v);
+        for (auto& n : names)
+            etor.match_name(n);
+        for (auto& t : tags)
+            etor.match_tag(t);
+        if (initialized)
+            etor.match_initialized();
+        for (auto& p : sysfs_paths)
+            etor.add_sysfs_path(p);
+    }
+
+
+    bool
+    MatchRules::matches(const Device& device)
+        const
+    {
+        GUdevDevice* dev = device.data();
+        if (!dev)
+            return false;
+
+        // Explicitly added paths are always part of the result.
+        if (!sysfs_paths.empty()) {
+            const char* path = g_udev_device_get_sysfs_path(dev);
+            if (path && std::ranges::find(sysfs_paths, path) != sysfs_paths.end())
+                return true;
+        }
+
+        if (initialized && !g_udev_device_get_is_initialized(dev))
+            return false;
+
+        const char* subsystem = g_udev_device_get_subsystem(dev);
+        if (!subsystems.empty() && !glob_match_any(subsystems, subsystem))
+            return false;
+        if (glob_match_any(nomatch_subsystems, subsystem))
+            return false;
+
+        // All sysfs attributes must match, none of the excluded ones may match.
+        for (auto& rule : sysfs_attrs)
+            if (!sysfs_attr_matches(dev, rule))
+                return false;
+        for (auto& rule : nomatch_sysfs_attrs)
+            if (sysfs_attr_matches(dev, rule))
+                return false;
+
+        // Any property may match.
+        if (!properties.empty()
+            && std::ranges::none_of(properties,
+                                    [dev](const auto& rule)
+                                    {
+                                        return property_matches(dev, rule);
+                                    }))
+            return false;
+
+        if (!names.empty() && !glob_match_any(names, g_udev_device_get_name(dev)))
+            return false;
+
+        // All tags must be present.
+        for (auto& t : tags)
+            if (!device.has_tag(t))
+                return false;
+
+        return true;
+    }
+
+} // namespace gudev
@@ -0,0 +1,270 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <algorithm>
+#include <exception>
+#include <optional>
+#include <utility>
+
+#include "gudevxx/MonitorHub.hpp"
+
+#include "gudevxx/Client.hpp"
+#include "gudevxx/Device.hpp"
+
+#include "stats.hpp"
+
+
+namespace gudev {
+
+    namespace {
+
+        std::string
+        subsystem_of(const std::string& entry)
+        {
+            return entry.substr(0, entry.find('/'));
+        }
+
+    } // namespace
+
+
+    MonitorHub&
+    MonitorHub::instance()
+    {
+        static MonitorHub hub;
+        return hub;
+    }
+
+
+    MonitorHub::MonitorHub() = default;
+
+
+    MonitorHub::~MonitorHub()
+        noexcept
+    {
+        if (retired_source)
+            g_source_remove(retired_source);
+    }
+
+
+    std::size_t
+    MonitorHub::num_clients()
+        const
+    {
+        std::lock_guard lock{mutex};
+        return registrations.size();
+    }
+
+
+    std::vector<std::string>
+    MonitorHub::filter()
+        const
+    {
+        std::lock_guard lock{mutex};
+        return socket_filter;
+    }
+
+
+    MonitorHub::Counters
+    MonitorHub::counters()
+        const
+    {
+        std::lock_guard lock{mutex};
+        return stats;
+    }
+
+
+    void
+    MonitorHub::add(GUdevClient* client,
+                    const std::vector<std::string>& subsystems)
+    {
+        std::lock_guard lock{mutex};
+        std::optional<std::vector<std::string>> previous;
+        if (auto it = registrations.find(client); it != registrations.end())
+            previous = it->second;
+        // Keep the object alive while registered, so dispatch never sees a freed client.
+        if (registrations.insert_or_assign(client, subsystems).second)
+            g_object_ref(client);
+
+        bool covered = monitor && socket_unfiltered;
+        if (monitor && !covered) {
+            covered = !subsystems.empty()
+                && std::ranges::all_of(subsystems,
+                                       [this](const std::string& entry)
+                                       {
+                                           return std::ranges::find(socket_filter,
+                                                                    subsystem_of(entry))
+                                               != socket_filter.end();
+                                       });
+        }
+        try {
+            rebuild_index();
+            if (!covered)
+                open_socket();
+        }
+        catch (...) {
+            // Undo the registration; the old socket is still in place.
+            if (previous)
+                registrations.insert_or_assign(client, std::move(*previous));
+            else {
+                registrations.erase(client);
+                g_object_unref(client);
+            }
+            rebuild_index();
+            throw;
+        }
+    }
+
+
+    void
+    MonitorHub::remove(GUdevClient* client)
+        noexcept
+    {
+        std::lock_guard lock{mutex};
+        if (!registrations.erase(client))
+            return;
+        g_object_unref(client);
+        try {
+            rebuild_index();
+        }
+        catch (std::exception& e) {
+            g_warning("MonitorHub::remove(): %s\n", e.what());
+        }
+        // Close the socket with the last client; the filter is not shrunk otherwise.
+        if (registrations.empty()) {
+            retire_monitor();
+            socket_filter.clear();
+            socket_unfiltered = false;
+        }
+    }
+
+
+    void
+    MonitorHub::rebuild_index()
+    {
+        by_subsystem.clear();
+        wildcard.clear();
+        for (auto& [client, subsystems] : registrations) {
+            if (subsystems.empty()) {
+                wildcard.push_back(client);
+                continue;
+            }
+            for (auto& entry : subsystems) {
+                auto slash = entry.find('/');
+                if (slash == std::string::npos)
+                    by_subsystem[entry].push_back(Target{client, {}});
+                else
+                    by_subsystem[entry.substr(0, slash)].push_back(Target{client, entry.substr(slash + 1)});
+            }
+        }
+    }
+
+
+    void
+    MonitorHub::open_socket()
+    {
+        const bool unfiltered = !wildcard.empty();
+        std::vector<std::string> filter;
+        if (!unfiltered) {
+            for (auto& [subsystem, targets] : by_subsystem)
+                filter.push_back(subsystem);
+            std::ranges::sort(filter);
+        }
+
+        // An empty filter list receives every event.
+        auto next = std::make_unique<Client>(filter);
+        next->uevent_callback = [this](const std::string& action,
+                                       Device& device)
+        {
+            dispatch(action, device);
+        };
+        retire_monitor();
+        monitor = std::move(next);
+        socket_unfiltered = unfiltered;
+        socket_filter = std::move(filter);
+        ++stats.sockets_opened;
+    }
+
+
+    void
+    MonitorHub::retire_monitor()
+        noexcept
+    {
+        if (!monitor)
+            return;
+        monitor->destroy();
+        retired.push_back(std::move(monitor));
+        if (!retired_source)
+            retired_source = g_idle_add(free_retired, this);
+    }
+
+
+    gboolean
+    MonitorHub::free_retired(gpointer data)
+        noexcept
+    {
+        auto hub = static_cast<MonitorHub*>(data);
+        std::vector<std::unique_ptr<Client>> victims;
+        {
+            std::lock_guard lock{hub->mutex};
+            victims = std::move(hub->retired);
+            hub->retired_source = 0;
+        }
+        return G_SOURCE_REMOVE;
+    }
+
+
+    void
+    MonitorHub::dispatch(const std::string& action,
+                         Device& device)
+    {
+        GUdevDevice* dev = device.data();
+        const char* subsystem = g_udev_device_get_subsystem(dev);
+
+        // Collect the targets first, so handlers can register and unregister clients.
+        std::vector<GUdevClient*> targets;
+        {
+            std::lock_guard lock{mutex};
+            ++stats.events_received;
+            targets = wildcard;
+            if (subsystem) {
+                auto it = by_subsystem.find(subsystem);
+                if (it != by_subsystem.end()) {
+                    const char* devtype = g_udev_device_get_devtype(dev);
+                    for (auto& t : it->second)
+                        if (t.devtype.empty() || (devtype && t.devtype == devtype))
+                            targets.push_back(t.client);
+                }
+            }
+            std::ranges::sort(targets);
+            auto [last, end] = std::ranges::unique(targets);
+            targets.erase(last, end);
+
+            // Routing is the shared monitor's subsystem filter: count what each client missed.
+            if (targets.empty())
+                stats::add(&detail::StatsCounters::events_filtered);
+            for (auto& [cli, subsystems] : registrations) {
+                if (std::ranges::binary_search(targets, cli))
+                    continue;
+                Client* client = Client::get_wrapper(cli);
+                if (client && client->stats_counters)
+                    client->stats_counters->events_filtered.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        for (auto cli : targets) {
+            {
+                std::lock_guard lock{mutex};
+                if (!registrations.contains(cli))
+                    continue;
+                ++stats.events_dispatched;
+            }
+            if (Client* client = Client::get_wrapper(cli))
+                client->receive_uevent(action.c_str(), dev);
+        }
+    }
+
+} // namespace gudev
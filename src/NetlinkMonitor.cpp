@@ -0,0 +1,688 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <endian.h>
+#include <linux/filter.h>
+#include <linux/netlink.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <glib.h>
+#include <glib-unix.h>
+
+#include "gudevxx/NetlinkMonitor.hpp"
+
+
+namespace gudev {
+
+    namespace {
+
+        // Same limits as libudev.
+        constexpr std::size_t message_size = 8192;
+
+        constexpr std::uint32_t udev_monitor_magic = 0xfeedcafe;
+
+
+        // Header prepended by libudev to messages in the "udev" group.
+        struct monitor_netlink_header {
+            char prefix[8];
+            std::uint32_t magic;
+            std::uint32_t header_size;
+            std::uint32_t properties_off;
+            std::uint32_t properties_len;
+            std::uint32_t filter_subsystem_hash;
+            std::uint32_t filter_devtype_hash;
+            std::uint32_t filter_tag_bloom_hi;
+            std::uint32_t filter_tag_bloom_lo;
+        };
+
+
+        std::string_view
+        next_string(std::string_view& list)
+            noexcept
+        {
+            auto end = list.find('\0');
+            auto s = list.substr(0, end);
+            list.remove_prefix(end == std::string_view::npos ? list.size() : end + 1);
+            return s;
+        }
+
+
+        [[noreturn]]
+        void
+        throw_errno(const char* what)
+        {
+            throw std::system_error{errno, std::system_category(), what};
+        }
+
+
+        // MurmurHash2 with seed 0, as used by libudev for the header hashes.
+        std::uint32_t
+        string_hash32(std::string_view str)
+            noexcept
+        {
+            constexpr std::uint32_t m = 0x5bd1e995;
+            auto data = reinterpret_cast<const unsigned char*>(str.data());
+            std::size_t len = str.size();
+            std::uint32_t h = len;
+            for (; len >= 4; data += 4, len -= 4) {
+                std::uint32_t k;
+                std::memcpy(&k, data, 4);
+                k *= m;
+                k ^= k >> 24;
+                k *= m;
+                h *= m;
+                h ^= k;
+            }
+            switch (len) {
+                case 3:
+                    h ^= data[2] << 16;
+                    [[fallthrough]];
+                case 2:
+                    h ^= data[1] << 8;
+                    [[fallthrough]];
+                case 1:
+                    h ^= data[0];
+                    h *= m;
+            }
+            h ^= h >> 13;
+            h *= m;
+            h ^= h >> 15;
+            return h;
+        }
+
+
+        std::uint64_t
+        string_bloom64(std::string_view str)
+            noexcept
+        {
+            std::uint32_t hash = string_hash32(str);
+            std::uint64_t bits = 0;
+            bits |= std::uint64_t{1} << (hash & 63);
+            bits |= std::uint64_t{1} << ((hash >> 6) & 63);
+            bits |= std::uint64_t{1} << ((hash >> 12) & 63);
+            bits |= std::uint64_t{1} << ((hash >> 18) & 63);
+            return bits;
+        }
+
+
+        std::pair<std::string_view, std::string_view>
+        split_subsystem(std::string_view entry)
+            noexcept
+        {
+            auto slash = entry.find('/');
+            if (slash == std::string_view::npos)
+                return {entry, {}};
+            return {entry.substr(0, slash), entry.substr(slash + 1)};
+        }
+
+
+        // Same program structure as libudev's udev_monitor_filter_update().
+        std::vector<sock_filter>
+        make_program(const NetlinkMonitor::Filter& filter)
+        {
+            constexpr std::uint32_t pass = 0xffffffff;
+            constexpr std::uint32_t drop = 0;
+            std::vector<sock_filter> prog;
+
+            auto stmt = [&prog](std::uint16_t code,
+                                std::uint32_t k)
+            {
+                prog.push_back(sock_filter{code, 0, 0, k});
+            };
+            auto jump = [&prog](std::uint16_t code,
+                                std::uint32_t k,
+                                std::uint8_t jt,
+                                std::uint8_t jf)
+            {
+                prog.push_back(sock_filter{code, jt, jf, k});
+            };
+            auto load = [&stmt](std::size_t offset)
+            {
+                stmt(BPF_LD | BPF_W | BPF_ABS, offset);
+            };
+
+            // Messages without the udev header can't be checked here.
+            load(offsetof(monitor_netlink_header, magic));
+            jump(BPF_JMP | BPF_JEQ | BPF_K, udev_monitor_magic, 1, 0);
+            stmt(BPF_RET | BPF_K, pass);
+
+            for (auto& [key, value] : filter.properties) {
+                std::size_t offset;
+                if (key == "SUBSYSTEM")
+                    offset = offsetof(monitor_netlink_header, filter_subsystem_hash);
+                else if (key == "DEVTYPE")
+                    offset = offsetof(monitor_netlink_header, filter_devtype_hash);
+                else
+                    continue;
+                load(offset);
+                jump(BPF_JMP | BPF_JEQ | BPF_K, string_hash32(value), 1, 0);
+                stmt(BPF_RET | BPF_K, drop);
+            }
+
+            if (!filter.tags.empty()) {
+                // Each tag block is 6 instructions; jump offsets are 8 bits.
+                if (filter.tags.size() > 40)
+                    throw std::length_error{"NetlinkMonitor::Filter: too many tags"};
+                std::size_t remaining = filter.tags.size();
+                for (auto& tag : filter.tags) {
+                    std::uint64_t bloom = string_bloom64(tag);
+                    std::uint32_t hi = bloom >> 32;
+                    std::uint32_t lo = bloom & 0xffffffff;
+                    load(offsetof(monitor_netlink_header, filter_tag_bloom_hi));
+                    stmt(BPF_ALU | BPF_AND | BPF_K, hi);
+                    jump(BPF_JMP | BPF_JEQ | BPF_K, hi, 0, 3);
+                    load(offsetof(monitor_netlink_header, filter_tag_bloom_lo));
+                    stmt(BPF_ALU | BPF_AND | BPF_K, lo);
+                    --remaining;
+                    jump(BPF_JMP | BPF_JEQ | BPF_K, lo, 1 + remaining * 6, 0);
+                }
+                stmt(BPF_RET | BPF_K, drop);
+            }
+
+            if (!filter.subsystems.empty()) {
+                for (auto& entry : filter.subsystems) {
+                    auto [subsystem, devtype] = split_subsystem(entry);
+                    load(offsetof(monitor_netlink_header, filter_subsystem_hash));
+                    if (devtype.empty())
+                        jump(BPF_JMP | BPF_JEQ | BPF_K, string_hash32(subsystem), 0, 1);
+                    else {
+                        jump(BPF_JMP | BPF_JEQ | BPF_K, string_hash32(subsystem), 0, 3);
+                        load(offsetof(monitor_netlink_header, filter_devtype_hash));
+                        jump(BPF_JMP | BPF_JEQ | BPF_K, string_hash32(devtype), 0, 1);
+                    }
+                    stmt(BPF_RET | BPF_K, pass);
+                }
+                stmt(BPF_RET | BPF_K, drop);
+            }
+
+            stmt(BPF_RET | BPF_K, pass);
+
+            if (prog.size() > BPF_MAXINSNS)
+                throw std::length_error{"NetlinkMonitor::Filter: program too large"};
+            return prog;
+        }
+
+
+        bool
+        tags_contain(std::string_view tags,
+                     std::string_view tag)
+            noexcept
+        {
+            // The TAGS property looks like ":tag1:tag2:".
+            while (!tags.empty()) {
+                auto end = tags.find(':');
+                if (tags.substr(0, end) == tag)
+                    return true;
+                if (end == std::string_view::npos)
+                    break;
+                tags.remove_prefix(end + 1);
+            }
+            return false;
+        }
+
+    } // namespace
+
+
+    bool
+    NetlinkMonitor::Filter::matches(const Uevent& event)
+        const
+    {
+        if (!subsystems.empty()
+            && std::ranges::none_of(subsystems,
+                                    [&event](const std::string& entry)
+                                    {
+                                        auto [subsystem, devtype] = split_subsystem(entry);
+                                        return subsystem == event.subsystem
+                                            && (devtype.empty() || devtype == event.devtype);
+                                    }))
+            return false;
+
+        if (!tags.empty()) {
+            auto event_tags = event.property("TAGS").value_or("");
+            if (std::ranges::none_of(tags,
+                                     [event_tags](const std::string& tag)
+                                     {
+                                         return tags_contain(event_tags, tag);
+                                     }))
+                return false;
+        }
+
+        return std::ranges::all_of(properties,
+                                   [&event](const auto& prop)
+                                   {
+                                       return event.property(prop.first) == prop.second;
+                                   });
+    }
+
+
+    std::optional<std::string_view>
+    Uevent::property(std::string_view key)
+        const noexcept
+    {
+        std::string_view list = properties;
+        while (!list.empty()) {
+            auto entry = next_string(list);
+            if (entry.size() > key.size()
+                && entry[key.size()] == '='
+                && entry.starts_with(key))
+                return entry.substr(key.size() + 1);
+        }
+        return {};
+    }
+
+
+    void
+    Uevent::for_each_property(const std::function<void (std::string_view,
+                                                        std::string_view)>& func)
+        const
+    {
+        std::string_view list = properties;
+        while (!list.empty()) {
+            auto entry = next_string(list);
+            auto eq = entry.find('=');
+            if (eq != std::string_view::npos)
+                func(entry.substr(0, eq), entry.substr(eq + 1));
+        }
+    }
+
+
+    std::string
+    Uevent::sysfs_path()
+        const
+    {
+        std::string result = "/sys";
+        result += devpath;
+        return result;
+    }
+
+
+    struct NetlinkMonitor::Slots {
+        std::vector<char> data;
+        std::vector<char> control;
+        std::vector<iovec> iov;
+        std::vector<sockaddr_nl> addr;
+        std::vector<mmsghdr> hdr;
+    };
+
+
+    NetlinkMonitor::NetlinkMonitor(std::nullptr_t)
+        noexcept
+    {}
+
+
+    NetlinkMonitor::NetlinkMonitor(Group group,
+                                   std::size_t batch_size)
+    {
+        int sock = socket(AF_NETLINK,
+                          SOCK_RAW | SOCK_CLOEXEC | SOCK_NONBLOCK,
+                          NETLINK_KOBJECT_UEVENT);
+        if (sock < 0)
+            throw_errno("socket(AF_NETLINK)");
+        acquire(sock);
+        is_netlink = true;
+
+        sockaddr_nl addr{};
+        addr.nl_family = AF_NETLINK;
+        addr.nl_groups = static_cast<unsigned>(group);
+        if (bind(sock, reinterpret_cast<sockaddr*>(&addr), sizeof addr) < 0)
+            throw_errno("bind(AF_NETLINK)");
+
+        int on = 1;
+        if (setsockopt(sock, SOL_SOCKET, SO_PASSCRED, &on, sizeof on) < 0)
+            throw_errno("setsockopt(SO_PASSCRED)");
+
+        allocate_slots(batch_size);
+    }
+
+
+    NetlinkMonitor
+    NetlinkMonitor::adopt(int fd,
+                          std::size_t batch_size)
+    {
+        NetlinkMonitor result;
+        result.acquire(fd);
+        result.check_credentials = false;
+        result.allocate_slots(batch_size);
+        return result;
+    }
+
+
+    NetlinkMonitor::~NetlinkMonitor()
+        noexcept
+    {
+        destroy();
+    }
+
+
+    NetlinkMonitor::NetlinkMonitor(NetlinkMonitor&& other)
+        noexcept :
+        BaseType{std::move(other)},
+        check_credentials{other.check_credentials},
+        uevent_callback{std::move(other.uevent_callback)},
+        is_netlink{other.is_netlink},
+        slots{std::move(other.slots)},
+        event_filter{std::move(other.event_filter)},
+        dispatch_batches{other.dispatch_batches},
+        stats{other.stats}
+    {
+        // The GLib source points to the old object, so it must be recreated.
+        if (other.source_id) {
+            other.detach();
+            attach(dispatch_batches);
+        }
+    }
+
+
+    NetlinkMonitor&
+    NetlinkMonitor::operator =(NetlinkMonitor&& other)
+        noexcept
+    {
+        if (this != &other) {
+            bool was_attached = other.source_id;
+            other.detach();
+            BaseType::operator =(std::move(other));
+            check_credentials = other.check_credentials;
+            uevent_callback = std::move(other.uevent_callback);
+            is_netlink = other.is_netlink;
+            slots = std::move(other.slots);
+            event_filter = std::move(other.event_filter);
+            stats = other.stats;
+            if (was_attached)
+                attach(other.dispatch_batches);
+        }
+        return *this;
+    }
+
+
+    void
+    NetlinkMonitor::destroy()
+        noexcept
+    {
+        detach();
+        auto fd = release();
+        if (fd >= 0)
+            close(fd);
+    }
+
+
+    int
+    NetlinkMonitor::fd()
+        const noexcept
+    {
+        return raw;
+    }
+
+
+    void
+    NetlinkMonitor::set_receive_buffer_size(int bytes,
+                                            bool force)
+    {
+        int opt = force ? SO_RCVBUFFORCE : SO_RCVBUF;
+        if (setsockopt(raw, SOL_SOCKET, opt, &bytes, sizeof bytes) < 0)
+            throw_errno(force ? "setsockopt(SO_RCVBUFFORCE)" : "setsockopt(SO_RCVBUF)");
+    }
+
+
+    void
+    NetlinkMonitor::set_filter(const Filter& filter)
+    {
+        auto prog = make_program(filter);
+        sock_fprog fprog{static_cast<unsigned short>(prog.size()), prog.data()};
+        if (setsockopt(raw, SOL_SOCKET, SO_ATTACH_FILTER, &fprog, sizeof fprog) < 0)
+            throw_errno("setsockopt(SO_ATTACH_FILTER)");
+        event_filter = filter;
+    }
+
+
+    void
+    NetlinkMonitor::clear_filter()
+    {
+        if (!event_filter)
+            return;
+        int dummy = 0;
+        if (setsockopt(raw, SOL_SOCKET, SO_DETACH_FILTER, &dummy, sizeof dummy) < 0)
+            throw_errno("setsockopt(SO_DETACH_FILTER)");
+        event_filter.reset();
+    }
+
+
+    const std::optional<NetlinkMonitor::Filter>&
+    NetlinkMonitor::filter()
+        const noexcept
+    {
+        return event_filter;
+    }
+
+
+    std::size_t
+    NetlinkMonitor::receive()
+    {
+        auto& s = *slots;
+        const std::size_t batch = s.hdr.size();
+        const std::size_t control_size = CMSG_SPACE(sizeof(ucred));
+
+        for (std::size_t i = 0; i < batch; ++i) {
+            auto& h = s.hdr[i].msg_hdr;
+            h = {};
+            h.msg_iov = &s.iov[i];
+            h.msg_iovlen = 1;
+            h.msg_control = s.control.data() + i * control_size;
+            h.msg_controllen = control_size;
+            if (is_netlink) {
+                h.msg_name = &s.addr[i];
+                h.msg_namelen = sizeof(sockaddr_nl);
+            }
+            s.hdr[i].msg_len = 0;
+        }
+
+        int n = recvmmsg(raw, s.hdr.data(), batch, MSG_DONTWAIT, nullptr);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+                return 0;
+            if (errno == ENOBUFS) {
+                // The kernel dropped messages; the socket is still usable.
+                ++stats.overflows;
+                return 0;
+            }
+            throw_errno("recvmmsg()");
+        }
+        ++stats.batches;
+        stats.messages += n;
+
+        std::size_t delivered = 0;
+        for (int i = 0; i < n; ++i) {
+            auto& h = s.hdr[i].msg_hdr;
+            if (h.msg_flags & (MSG_TRUNC | MSG_CTRUNC)) {
+                ++stats.rejected;
+                continue;
+            }
+
+            if (is_netlink) {
+                // Reject unicast messages, and messages in the kernel group not sent by the kernel.
+                if (s.addr[i].nl_groups == 0
+                    || (s.addr[i].nl_groups == unsigned(Group::kernel) && s.addr[i].nl_pid != 0)) {
+                    ++stats.rejected;
+                    continue;
+                }
+            }
+
+            if (check_credentials) {
+                cmsghdr* cmsg = CMSG_FIRSTHDR(&h);
+                if (!cmsg
+                    || cmsg->cmsg_level != SOL_SOCKET
+                    || cmsg->cmsg_type != SCM_CREDENTIALS) {
+                    ++stats.rejected;
+                    continue;
+                }
+                ucred cred;
+                std::memcpy(&cred, CMSG_DATA(cmsg), sizeof cred);
+                if (cred.uid != 0) {
+                    ++stats.rejected;
+                    continue;
+                }
+            }
+
+            Uevent event;
+            std::span<const char> msg{s.data.data() + i * message_size, s.hdr[i].msg_len};
+            if (!parse(msg, event)) {
+                ++stats.rejected;
+                continue;
+            }
+            if (event_filter && !event_filter->matches(event)) {
+                ++stats.filtered;
+                continue;
+            }
+            if (uevent_callback)
+                uevent_callback(event);
+            ++delivered;
+        }
+        return delivered;
+    }
+
+
+    void
+    NetlinkMonitor::attach(unsigned max_batches)
+    {
+        dispatch_batches = std::max(max_batches, 1u);
+        if (source_id || !is_valid())
+            return;
+        source_id = g_unix_fd_add(raw,
+                                  G_IO_IN,
+                                  [](gint, GIOCondition, gpointer data) -> gboolean
+                                  {
+                                      auto self = static_cast<NetlinkMonitor*>(data);
+                                      try {
+                                          /*
+                                           * Stop after a few batches even if more are pending: the fd
+                                           * stays readable, so we're called again after other sources
+                                           * had their turn.
+                                           */
+                                          for (unsigned b = 0; b < self->dispatch_batches; ++b) {
+                                              const auto before = self->stats.messages;
+                                              self->receive();
+                                              if (self->stats.messages == before)
+                                                  break;
+                                          }
+                                      }
+                                      catch (std::exception& e) {
+                                          g_warning("Exception in NetlinkMonitor: %s\n", e.what());
+                                      }
+                                      return G_SOURCE_CONTINUE;
+                                  },
+                                  this);
+    }
+
+
+    void
+    NetlinkMonitor::detach()
+        noexcept
+    {
+        if (source_id) {
+            g_source_remove(source_id);
+            source_id = 0;
+        }
+    }
+
+
+    NetlinkMonitor::Counters
+    NetlinkMonitor::counters()
+        const noexcept
+    {
+        return stats;
+    }
+
+
+    bool
+    NetlinkMonitor::parse(std::span<const char> message,
+                          Uevent& event)
+        noexcept
+    {
+        std::string_view msg{message.data(), message.size()};
+        std::string_view list;
+
+        if (msg.size() >= sizeof(monitor_netlink_header)
+            && std::memcmp(msg.data(), "libudev", 8) == 0) {
+            monitor_netlink_header header;
+            std::memcpy(&header, msg.data(), sizeof header);
+            if (header.magic != htobe32(udev_monitor_magic))
+                return false;
+            if (header.properties_off < sizeof header
+                || header.properties_off > msg.size()
+                || header.properties_len > msg.size() - header.properties_off)
+                return false;
+            list = msg.substr(header.properties_off, header.properties_len);
+            event.from_kernel = false;
+        } else {
+            // Kernel format: "action@devpath\0" followed by the properties.
+            auto head = msg.substr(0, msg.find('\0'));
+            auto at = head.find('@');
+            if (at == std::string_view::npos || head.size() == msg.size())
+                return false;
+            event.action = head.substr(0, at);
+            event.devpath = head.substr(at + 1);
+            list = msg.substr(head.size() + 1);
+            event.from_kernel = true;
+        }
+
+        // Drop any trailing null, so it's not taken as an empty property.
+        while (!list.empty() && list.back() == '\0')
+            list.remove_suffix(1);
+        event.properties = list;
+
+        while (!list.empty()) {
+            auto entry = next_string(list);
+            auto eq = entry.find('=');
+            if (eq == std::string_view::npos)
+                continue;
+            auto key = entry.substr(0, eq);
+            auto val = entry.substr(eq + 1);
+            if (key == "ACTION")
+                event.action = val;
+            else if (key == "DEVPATH")
+                event.devpath = val;
+            else if (key == "SUBSYSTEM")
+                event.subsystem = val;
+            else if (key == "DEVTYPE")
+                event.devtype = val;
+            else if (key == "SEQNUM")
+                std::from_chars(val.data(), val.data() + val.size(), event.seqnum);
+        }
+
+        return !event.action.empty() && !event.devpath.empty();
+    }
+
+
+    void
+    NetlinkMonitor::allocate_slots(std::size_t batch_size)
+    {
+        if (!batch_size)
+            batch_size = 1;
+        const std::size_t control_size = CMSG_SPACE(sizeof(ucred));
+        slots = std::make_unique<Slots>();
+        slots->data.resize(batch_size * message_size);
+        slots->control.resize(batch_size * control_size);
+        slots->iov.resize(batch_size);
+        slots->addr.resize(batch_size);
+        slots->hdr.resize(batch_size);
+        for (std::size_t i = 0; i < batch_size; ++i) {
+            slots->iov[i].iov_base = slots->data.data() + i * message_size;
+            slots->iov[i].iov_len = message_size;
+        }
+    }
+
+} // namespace gudev
@@ -0,0 +1,169 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <filesystem>
+#include <set>
+#include <system_error>
+#include <thread>
+#include <utility>
+
+#include <fnmatch.h>
+
+#include "gudevxx/ParallelEnumerator.hpp"
+
+#include "gudevxx/Client.hpp"
+#include "gudevxx/Enumerator.hpp"
+
+
+namespace gudev {
+
+    namespace {
+
+        bool
+        glob_match_any(const std::vector<std::string>& patterns,
+                       const std::string& value)
+        {
+            return std::ranges::any_of(patterns,
+                                       [&value](const std::string& p)
+                                       {
+                                           return fnmatch(p.c_str(), value.c_str(), 0) == 0;
+                                       });
+        }
+
+
+        void
+        list_dir(const std::filesystem::path& dir,
+                 std::set<std::string>& names)
+        {
+            std::error_code ec;
+            for (auto& entry : std::filesystem::directory_iterator{dir, ec})
+                names.insert(entry.path().filename().string());
+        }
+
+    } // namespace
+
+
+    ParallelEnumerator::ParallelEnumerator(MatchRules rules,
+                                           unsigned num_threads) :
+        match_rules{std::move(rules)},
+        num_threads{num_threads}
+    {}
+
+
+    const MatchRules&
+    ParallelEnumerator::rules()
+        const noexcept
+    {
+        return match_rules;
+    }
+
+
+    MatchRules&
+    ParallelEnumerator::rules()
+        noexcept
+    {
+        return match_rules;
+    }
+
+
+    std::vector<std::string>
+    ParallelEnumerator::subsystems()
+        const
+    {
+        std::set<std::string> names;
+        list_dir("/sys/bus", names);
+        list_dir("/sys/class", names);
+
+        std::vector<std::string> result;
+        for (auto& name : names) {
+            if (!match_rules.subsystems.empty()
+                && !glob_match_any(match_rules.subsystems, name))
+                continue;
+            if (glob_match_any(match_rules.nomatch_subsystems, name))
+                continue;
+            result.push_back(name);
+        }
+        return result;
+    }
+
+
+    std::vector<Device>
+    ParallelEnumerator::execute()
+    {
+        const auto tasks = subsystems();
+        std::vector<std::vector<Device>> partial(tasks.size());
+
+        // Each task replaces the subsystem rules with a single subsystem, and
+        // explicit sysfs paths are handled once, after merging.
+        MatchRules task_rules = match_rules;
+        task_rules.subsystems.clear();
+        task_rules.nomatch_subsystems.clear();
+        task_rules.sysfs_paths.clear();
+
+        unsigned workers = num_threads ? num_threads : std::thread::hardware_concurrency();
+        workers = std::clamp<unsigned>(workers, 1, std::max<std::size_t>(tasks.size(), 1));
+
+        std::atomic_size_t next_task = 0;
+        std::vector<std::exception_ptr> errors(workers);
+
+        auto work = [&](unsigned id)
+        {
+            try {
+                Client client;
+                for (std::size_t i = next_task++; i < tasks.size(); i = next_task++) {
+                    Enumerator etor{client};
+                    task_rules.apply(etor);
+                    etor.match_subsystem(tasks[i]);
+                    partial[i] = etor.execute();
+                }
+            }
+            catch (...) {
+                errors[id] = std::current_exception();
+                next_task = tasks.size();
+            }
+        };
+
+        {
+            std::vector<std::jthread> threads;
+            for (unsigned id = 1; id < workers; ++id)
+                threads.emplace_back(work, id);
+            work(0);
+        }
+
+        for (auto& e : errors)
+            if (e)
+                std::rethrow_exception(e);
+
+        std::vector<Device> result;
+        std::set<std::filesystem::path> seen;
+        for (auto& devs : partial)
+            for (auto& dev : devs) {
+                if (!match_rules.sysfs_paths.empty())
+                    if (auto path = dev.sysfs())
+                        seen.insert(std::move(*path));
+                result.push_back(std::move(dev));
+            }
+
+        if (!match_rules.sysfs_paths.empty()) {
+            Client client;
+            for (auto& path : match_rules.sysfs_paths) {
+                if (seen.contains(path))
+                    continue;
+                if (auto dev = client.get_sysfs(path)) {
+                    seen.insert(path);
+                    result.push_back(std::move(*dev));
+                }
+            }
+        }
+
+        return result;
+    }
+
+} // namespace gudev
@@ -0,0 +1,474 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <unordered_map>
+
+#include <fnmatch.h>
+
+#include "gudevxx/RuleEngine.hpp"
+
+#include "gudevxx/NetlinkMonitor.hpp"
+
+
+using std::string;
+using std::string_view;
+using std::vector;
+
+
+namespace gudev {
+
+    namespace {
+
+        struct string_hash {
+
+            using is_transparent = void;
+
+            std::size_t
+            operator ()(string_view s)
+                const noexcept
+            {
+                return std::hash<string_view>{}(s);
+            }
+
+        };
+
+
+        template<typename T>
+        using string_map = std::unordered_map<string, T, string_hash, std::equal_to<>>;
+
+
+        enum class PatternKind {
+            exact,
+            prefix,
+            glob
+        };
+
+
+        PatternKind
+        classify(const string& pattern)
+        {
+            auto pos = pattern.find_first_of("*?[\\");
+            if (pos == string::npos)
+                return PatternKind::exact;
+            if (pos == pattern.size() - 1 && pattern.back() == '*')
+                return PatternKind::prefix;
+            return PatternKind::glob;
+        }
+
+
+        bool
+        glob_match(const string& pattern,
+                   const char* value)
+        {
+            return value && fnmatch(pattern.c_str(), value, 0) == 0;
+        }
+
+
+        // Checks for ":tag:" in a udev TAGS property.
+        bool
+        tags_contain(string_view tags,
+                     string_view tag)
+        {
+            for (std::size_t pos = tags.find(tag);
+                 pos != string_view::npos;
+                 pos = tags.find(tag, pos + 1)) {
+                bool start = pos == 0 || tags[pos - 1] == ':';
+                bool end = pos + tag.size() == tags.size() || tags[pos + tag.size()] == ':';
+                if (start && end)
+                    return true;
+            }
+            return false;
+        }
+
+    } // namespace
+
+
+    struct RuleEngine::Compiled {
+
+        // Rules for one subsystem, split by action.
+        struct Bucket {
+            string_map<vector<std::uint32_t>> by_action;
+            vector<std::uint32_t> any_action;
+        };
+
+        struct TrieNode {
+            vector<std::pair<char, std::uint32_t>> children; // sorted after compilation
+            vector<std::uint32_t> exact;  // conditions matching the string up to here
+            vector<std::uint32_t> prefix; // conditions matching anything starting here
+        };
+
+        struct KeyIndex {
+            std::uint32_t root;
+            vector<std::pair<string, std::uint32_t>> globs;
+        };
+
+        struct RuleInfo {
+            rule_id id;
+            std::uint32_t num_properties;
+            vector<string> tags;
+            vector<std::pair<string, string>> sysfs_attrs;
+        };
+
+
+        vector<RuleInfo> rules;
+
+        string_map<Bucket> by_subsystem;
+        vector<std::pair<string, Bucket>> glob_subsystems;
+        Bucket any_subsystem;
+
+        string_map<KeyIndex> keys;
+        vector<TrieNode> nodes;
+        // Condition index -> rule indices.
+        vector<vector<std::uint32_t>> conditions;
+
+
+        explicit
+        Compiled(std::span<const Rule> src)
+        {
+            std::map<std::pair<string, string>, std::uint32_t> condition_ids;
+
+            rules.reserve(src.size());
+            for (auto& rule : src) {
+                const std::uint32_t idx = rules.size();
+
+                auto props = rule.properties;
+                std::ranges::sort(props);
+                auto [dup_begin, dup_end] = std::ranges::unique(props);
+                props.erase(dup_begin, dup_end);
+
+                rules.push_back(RuleInfo{
+                        rule.id,
+                        static_cast<std::uint32_t>(props.size()),
+                        rule.tags,
+                        rule.sysfs_attrs
+                    });
+
+                add_to_buckets(rule, idx);
+
+                for (auto& prop : props) {
+                    auto [it, inserted] = condition_ids.try_emplace(prop, conditions.size());
+                    if (inserted) {
+                        conditions.emplace_back();
+                        add_condition(prop.first, prop.second, it->second);
+                    }
+                    conditions[it->second].push_back(idx);
+                }
+            }
+
+            for (auto& node : nodes)
+                std::ranges::sort(node.children);
+        }
+
+
+        void
+        add_to_bucket(Bucket& bucket,
+                      const Rule& rule,
+                      std::uint32_t idx)
+        {
+            if (rule.actions.empty())
+                bucket.any_action.push_back(idx);
+            for (auto& action : rule.actions)
+                bucket.by_action[action].push_back(idx);
+        }
+
+
+        void
+        add_to_buckets(const Rule& rule,
+                       std::uint32_t idx)
+        {
+            if (rule.subsystems.empty()) {
+                add_to_bucket(any_subsystem, rule, idx);
+                return;
+            }
+            for (auto& subsystem : rule.subsystems) {
+                if (classify(subsystem) == PatternKind::exact) {
+                    add_to_bucket(by_subsystem[subsystem], rule, idx);
+                    continue;
+                }
+                auto it = std::ranges::find(glob_subsystems, subsystem,
+                                            &std::pair<string, Bucket>::first);
+                if (it == glob_subsystems.end())
+                    it = glob_subsystems.insert(it, {subsystem, {}});
+                add_to_bucket(it->second, rule, idx);
+            }
+        }
+
+
+        std::uint32_t
+        new_node()
+        {
+            nodes.emplace_back();
+            return nodes.size() - 1;
+        }
+
+
+        void
+        add_condition(const string& key,
+                      const string& pattern,
+                      std::uint32_t cond)
+        {
+            auto it = keys.find(key);
+            if (it == keys.end())
+                it = keys.emplace(key, KeyIndex{new_node(), {}}).first;
+            KeyIndex& index = it->second;
+
+            auto kind = classify(pattern);
+            if (kind == PatternKind::glob) {
+                index.globs.emplace_back(pattern, cond);
+                return;
+            }
+
+            string_view literal = pattern;
+            if (kind == PatternKind::prefix)
+                literal.remove_suffix(1);
+
+            std::uint32_t n = index.root;
+            for (char c : literal) {
+                auto& children = nodes[n].children;
+                auto child = std::ranges::find(children, c, &std::pair<char, std::uint32_t>::first);
+                if (child != children.end()) {
+                    n = child->second;
+                } else {
+                    std::uint32_t m = new_node();
+                    nodes[n].children.emplace_back(c, m);
+                    n = m;
+                }
+            }
+
+            if (kind == PatternKind::exact)
+                nodes[n].exact.push_back(cond);
+            else
+                nodes[n].prefix.push_back(cond);
+        }
+
+
+        void
+        collect(const Bucket& bucket,
+                string_view action,
+                vector<std::uint32_t>& candidates)
+            const
+        {
+            if (!action.empty()) {
+                auto it = bucket.by_action.find(action);
+                if (it != bucket.by_action.end())
+                    candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+            }
+            candidates.insert(candidates.end(), bucket.any_action.begin(), bucket.any_action.end());
+        }
+
+
+        void
+        satisfy(const vector<std::uint32_t>& conds,
+                vector<std::uint32_t>& counts)
+            const
+        {
+            for (auto cond : conds)
+                for (auto idx : conditions[cond])
+                    ++counts[idx];
+        }
+
+
+        // Marks every condition satisfied by one property.
+        void
+        visit_property(string_view key,
+                       string_view value,
+                       vector<std::uint32_t>& counts)
+            const
+        {
+            auto it = keys.find(key);
+            if (it == keys.end())
+                return;
+            const KeyIndex& index = it->second;
+
+            const TrieNode* node = &nodes[index.root];
+            satisfy(node->prefix, counts);
+            bool complete = true;
+            for (char c : value) {
+                auto child = std::ranges::lower_bound(node->children, c, {},
+                                                      &std::pair<char, std::uint32_t>::first);
+                if (child == node->children.end() || child->first != c) {
+                    complete = false;
+                    break;
+                }
+                node = &nodes[child->second];
+                satisfy(node->prefix, counts);
+            }
+            if (complete)
+                satisfy(node->exact, counts);
+
+            if (!index.globs.empty()) {
+                const string str{value};
+                for (auto& [pattern, cond] : index.globs)
+                    if (glob_match(pattern, str.c_str()))
+                        satisfy({cond}, counts);
+            }
+        }
+
+
+        template<typename ForEachProperty,
+                 typename HasTag,
+                 typename GetSysfsAttr>
+        vector<rule_id>
+        evaluate(string_view subsystem,
+                 string_view action,
+                 ForEachProperty&& for_each_property,
+                 HasTag&& has_tag,
+                 GetSysfsAttr&& get_sysfs_attr)
+            const
+        {
+            vector<std::uint32_t> candidates;
+
+            if (!subsystem.empty()) {
+                auto it = by_subsystem.find(subsystem);
+                if (it != by_subsystem.end())
+                    collect(it->second, action, candidates);
+                if (!glob_subsystems.empty()) {
+                    const string str{subsystem};
+                    for (auto& [pattern, bucket] : glob_subsystems)
+                        if (glob_match(pattern, str.c_str()))
+                            collect(bucket, action, candidates);
+                }
+            }
+            collect(any_subsystem, action, candidates);
+
+            vector<rule_id> result;
+            if (candidates.empty())
+                return result;
+
+            // A rule may be in more than one bucket.
+            std::ranges::sort(candidates);
+            auto [dup_begin, dup_end] = std::ranges::unique(candidates);
+            candidates.erase(dup_begin, dup_end);
+
+            vector<std::uint32_t> counts;
+            if (std::ranges::any_of(candidates,
+                                    [this](std::uint32_t idx)
+                                    {
+                                        return rules[idx].num_properties > 0;
+                                    })) {
+                counts.resize(rules.size());
+                for_each_property([this, &counts](string_view key, string_view value)
+                {
+                    visit_property(key, value, counts);
+                });
+            }
+
+            for (auto idx : candidates) {
+                const RuleInfo& rule = rules[idx];
+                if (rule.num_properties > 0 && counts[idx] != rule.num_properties)
+                    continue;
+                if (!std::ranges::all_of(rule.tags, has_tag))
+                    continue;
+                if (!std::ranges::all_of(rule.sysfs_attrs,
+                                         [&get_sysfs_attr](const auto& attr)
+                                         {
+                                             return glob_match(attr.second,
+                                                               get_sysfs_attr(attr.first));
+                                         }))
+                    continue;
+                result.push_back(rule.id);
+            }
+
+            std::ranges::sort(result);
+            return result;
+        }
+
+    }; // struct RuleEngine::Compiled
+
+
+    RuleEngine::RuleEngine()
+        noexcept = default;
+
+
+    RuleEngine::RuleEngine(std::span<const Rule> rules) :
+        compiled{std::make_unique<Compiled>(rules)}
+    {}
+
+
+    RuleEngine::~RuleEngine()
+        noexcept = default;
+
+
+    RuleEngine::RuleEngine(RuleEngine&& other)
+        noexcept = default;
+
+
+    RuleEngine&
+    RuleEngine::operator =(RuleEngine&& other)
+        noexcept = default;
+
+
+    std::size_t
+    RuleEngine::size()
+        const noexcept
+    {
+        return compiled ? compiled->rules.size() : 0;
+    }
+
+
+    vector<RuleEngine::rule_id>
+    RuleEngine::match(const Device& device,
+                      std::optional<zstring_view> action)
+        const
+    {
+        GUdevDevice* dev = device.data();
+        if (!compiled || !dev)
+            return {};
+
+        const char* subsystem = g_udev_device_get_subsystem(dev);
+        const char* act = action ? action->c_str() : g_udev_device_get_action(dev);
+
+        return compiled->evaluate(subsystem ? subsystem : "",
+                                  act ? act : "",
+                                  [&device, dev](auto&& visit)
+                                  {
+                                      auto keys = device.property_keys_view();
+                                      for (std::size_t i = 0; i < keys.size(); ++i) {
+                                          const char* val = g_udev_device_get_property(dev, keys.c_str(i));
+                                          visit(keys[i], val ? val : "");
+                                      }
+                                  },
+                                  [&device](const string& tag)
+                                  {
+                                      return device.has_tag(tag);
+                                  },
+                                  [dev](const string& key)
+                                  {
+                                      return g_udev_device_get_sysfs_attr(dev, key.c_str());
+                                  });
+    }
+
+
+    vector<RuleEngine::rule_id>
+    RuleEngine::match(const Uevent& event)
+        const
+    {
+        if (!compiled)
+            return {};
+
+        const auto tags = event.property("TAGS").value_or("");
+
+        return compiled->evaluate(event.subsystem,
+                                  event.action,
+                                  [&event](auto&& visit)
+                                  {
+                                      event.for_each_property(visit);
+                                  },
+                                  [tags](const string& tag)
+                                  {
+                                      return tags_contain(tags, tag);
+                                  },
+                                  [](const string&) -> const char*
+                                  {
+                                      return nullptr;
+                                  });
+    }
+
+} // namespace gudev
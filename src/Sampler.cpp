@@ -0,0 +1,359 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <ctime>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <glib.h>
+#include <glib-unix.h>
+
+#include "gudevxx/Sampler.hpp"
+
+#include "dirent.hpp"
+
+
+namespace gudev {
+
+    namespace {
+
+        [[noreturn]]
+        void
+        throw_errno(const char* what)
+        {
+            throw std::system_error{errno, std::system_category(), what};
+        }
+
+
+        std::int64_t
+        monotonic_ns()
+            noexcept
+        {
+            timespec ts;
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            return std::int64_t{ts.tv_sec} * 1'000'000'000 + ts.tv_nsec;
+        }
+
+
+        template<typename T>
+        bool
+        parse(const char* first,
+              const char* last,
+              T& out)
+            noexcept
+        {
+            while (first != last && (*first == ' ' || *first == '\t'))
+                ++first;
+            // from_chars() doesn't accept a leading '+'.
+            if (first != last && *first == '+')
+                ++first;
+            auto [ptr, ec] = std::from_chars(first, last, out);
+            return ec == std::errc{} && ptr != first;
+        }
+
+
+        void
+        set_timer(int fd,
+                  std::chrono::milliseconds period)
+        {
+            itimerspec spec{};
+            auto sec = std::chrono::duration_cast<std::chrono::seconds>(period);
+            auto nsec = std::chrono::duration_cast<std::chrono::nanoseconds>(period - sec);
+            spec.it_interval.tv_sec = sec.count();
+            spec.it_interval.tv_nsec = nsec.count();
+            spec.it_value = spec.it_interval;
+            if (timerfd_settime(fd, 0, &spec, nullptr) < 0)
+                throw_errno("timerfd_settime()");
+        }
+
+    } // namespace
+
+
+    Sampler::Sampler(std::size_t capacity) :
+        cap{std::max<std::size_t>(capacity, 1)}
+    {}
+
+
+    Sampler::~Sampler()
+        noexcept
+    {
+        detach();
+        for (auto& s : series)
+            close(s.fd);
+        for (auto& g : groups)
+            if (g.timer_fd >= 0)
+                close(g.timer_fd);
+    }
+
+
+    Sampler::series_id
+    Sampler::add(const Device& device,
+                 zstring_view attr,
+                 Type type,
+                 std::chrono::milliseconds period)
+    {
+        auto path = device.sysfs();
+        if (!path)
+            throw std::invalid_argument{"Sampler::add(): device has no sysfs path"};
+        return add(*path, attr, type, period);
+    }
+
+
+    Sampler::series_id
+    Sampler::add(const std::filesystem::path& sysfs_path,
+                 zstring_view attr,
+                 Type type,
+                 std::chrono::milliseconds period)
+    {
+        if (period <= std::chrono::milliseconds::zero())
+            throw std::invalid_argument{"Sampler::add(): period must be positive"};
+
+        auto file = sysfs_path / attr.view();
+        detail::unique_fd fd{open(file.c_str(), O_RDONLY | O_CLOEXEC)};
+        if (!fd)
+            throw_errno("open()");
+
+        // Reserve first, so nothing can throw once the fd is handed to the series.
+        series.reserve(series.size() + 1);
+        groups.reserve(groups.size() + 1);
+        auto g = std::ranges::find(groups, period, &Group::period);
+        if (g == groups.end()) {
+            Group ng;
+            ng.period = period;
+            ng.timestamps.resize(cap);
+            ng.members.reserve(1);
+            // Without this, a new period would never be sampled until the next start().
+            if (started)
+                arm_group(ng);
+            groups.push_back(std::move(ng));
+            g = groups.end() - 1;
+            if (attached)
+                attach_group(*g);
+        } else
+            g->members.reserve(g->members.size() + 1);
+
+        std::size_t slot = 0;
+        switch (type) {
+            case Type::u64:
+                slot = u64_values.size() / cap;
+                u64_values.resize(u64_values.size() + cap);
+                break;
+            case Type::i64:
+                slot = i64_values.size() / cap;
+                i64_values.resize(i64_values.size() + cap);
+                break;
+            case Type::f64:
+                slot = f64_values.size() / cap;
+                f64_values.resize(f64_values.size() + cap);
+                break;
+        }
+        valid_flags.resize(valid_flags.size() + cap);
+
+        const series_id id = series.size();
+        series.push_back(Series{fd.release(), type, std::size_t(g - groups.begin()), slot});
+        // Joining a group that already has samples: the older ones read as invalid.
+        g->members.push_back(id);
+        return id;
+    }
+
+
+    std::size_t
+    Sampler::size()
+        const noexcept
+    {
+        return series.size();
+    }
+
+
+    std::size_t
+    Sampler::capacity()
+        const noexcept
+    {
+        return cap;
+    }
+
+
+    Sampler::Type
+    Sampler::type(series_id id)
+        const
+    {
+        return series.at(id).type;
+    }
+
+
+    void
+    Sampler::start()
+    {
+        for (auto& g : groups)
+            arm_group(g);
+        started = true;
+    }
+
+
+    void
+    Sampler::stop()
+        noexcept
+    {
+        started = false;
+        itimerspec spec{};
+        for (auto& g : groups)
+            if (g.timer_fd >= 0)
+                timerfd_settime(g.timer_fd, 0, &spec, nullptr);
+    }
+
+
+    void
+    Sampler::arm_group(Group& g)
+    {
+        if (g.timer_fd < 0) {
+            detail::unique_fd fd{timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC)};
+            if (!fd)
+                throw_errno("timerfd_create()");
+            set_timer(fd.get(), g.period);
+            g.timer_fd = fd.release();
+        } else
+            set_timer(g.timer_fd, g.period);
+    }
+
+
+    std::size_t
+    Sampler::dispatch()
+    {
+        std::size_t sampled = 0;
+        for (std::size_t i = 0; i < groups.size(); ++i) {
+            auto& g = groups[i];
+            if (g.timer_fd < 0)
+                continue;
+            std::uint64_t expirations;
+            if (read(g.timer_fd, &expirations, sizeof expirations) != sizeof expirations)
+                continue;
+            stats.overruns += expirations - 1;
+            sample_group(i);
+            ++sampled;
+        }
+        return sampled;
+    }
+
+
+    void
+    Sampler::sample_all()
+    {
+        for (std::size_t i = 0; i < groups.size(); ++i)
+            sample_group(i);
+    }
+
+
+    void
+    Sampler::sample_group(std::size_t gi)
+    {
+        Group& g = groups[gi];
+        const std::size_t pos = g.head;
+        g.timestamps[pos] = monotonic_ns();
+
+        // sysfs attributes never exceed one page; numbers are much shorter.
+        char buf[128];
+        for (auto id : g.members) {
+            const Series& s = series[id];
+            ssize_t n = pread(s.fd, buf, sizeof buf, 0);
+            bool ok = n > 0;
+            if (ok) {
+                const char* last = buf + n;
+                switch (s.type) {
+                    case Type::u64:
+                        ok = parse(buf, last, u64_values[s.slot * cap + pos]);
+                        break;
+                    case Type::i64:
+                        ok = parse(buf, last, i64_values[s.slot * cap + pos]);
+                        break;
+                    case Type::f64:
+                        ok = parse(buf, last, f64_values[s.slot * cap + pos]);
+                        break;
+                }
+            }
+            valid_flags[id * cap + pos] = ok;
+            if (ok)
+                ++stats.samples;
+            else
+                ++stats.read_errors;
+        }
+
+        g.head = (g.head + 1) % cap;
+        g.count = std::min(g.count + 1, cap);
+    }
+
+
+    void
+    Sampler::attach()
+    {
+        for (auto& g : groups)
+            attach_group(g);
+        attached = true;
+    }
+
+
+    void
+    Sampler::attach_group(Group& g)
+    {
+        if (g.source_id || g.timer_fd < 0)
+            return;
+        g.source_id = g_unix_fd_add(g.timer_fd,
+                                    G_IO_IN,
+                                    dispatch_timer,
+                                    this);
+    }
+
+
+    gboolean
+    Sampler::dispatch_timer(gint fd,
+                            GIOCondition /*condition*/,
+                            gpointer data)
+        noexcept
+    {
+        auto self = static_cast<Sampler*>(data);
+        std::uint64_t expirations;
+        if (read(fd, &expirations, sizeof expirations) != sizeof expirations)
+            return G_SOURCE_CONTINUE;
+        self->stats.overruns += expirations - 1;
+        auto g = std::ranges::find(self->groups, fd, &Group::timer_fd);
+        try {
+            if (g != self->groups.end())
+                self->sample_group(g - self->groups.begin());
+        }
+        catch (std::exception& e) {
+            g_warning("Exception in Sampler: %s\n", e.what());
+        }
+        return G_SOURCE_CONTINUE;
+    }
+
+
+    void
+    Sampler::detach()
+        noexcept
+    {
+        attached = false;
+        for (auto& g : groups)
+            if (g.source_id) {
+                g_source_remove(g.source_id);
+                g.source_id = 0;
+            }
+    }
+
+
+    Sampler::Counters
+    Sampler::counters()
+        const noexcept
+    {
+        return stats;
+    }
+
+} // namespace gudev
@@ -0,0 +1,177 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <algorithm>
+#include <bit>
+
+#include "gudevxx/Stats.hpp"
+
+#include "stats.hpp"
+
+
+namespace gudev {
+
+    std::chrono::nanoseconds
+    Histogram::mean()
+        const noexcept
+    {
+        if (!count)
+            return {};
+        return std::chrono::nanoseconds(sum_ns / count);
+    }
+
+
+    std::chrono::nanoseconds
+    Histogram::percentile(double p)
+        const noexcept
+    {
+        if (!count)
+            return {};
+        p = std::clamp(p, 0.0, 1.0);
+        auto target = static_cast<std::uint64_t>(p * count);
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < num_buckets; ++i) {
+            seen += buckets[i];
+            if (seen > target || seen == count) {
+                std::uint64_t upper = i ? (std::uint64_t{1} << i) - 1 : 0;
+                return std::chrono::nanoseconds(std::min(upper, max_ns));
+            }
+        }
+        return std::chrono::nanoseconds(max_ns);
+    }
+
+
+    namespace detail {
+
+        void
+        AtomicHistogram::record(std::chrono::nanoseconds t)
+            noexcept
+        {
+            auto ns = static_cast<std::uint64_t>(std::max<std::int64_t>(t.count(), 0));
+            std::size_t idx = std::min<std::size_t>(std::bit_width(ns), Histogram::num_buckets - 1);
+            buckets[idx].fetch_add(1, std::memory_order_relaxed);
+            count.fetch_add(1, std::memory_order_relaxed);
+            sum_ns.fetch_add(ns, std::memory_order_relaxed);
+            auto old_max = max_ns.load(std::memory_order_relaxed);
+            while (old_max < ns
+                   && !max_ns.compare_exchange_weak(old_max, ns, std::memory_order_relaxed))
+                {}
+        }
+
+
+        Histogram
+        AtomicHistogram::load()
+            const noexcept
+        {
+            Histogram result;
+            for (std::size_t i = 0; i < Histogram::num_buckets; ++i)
+                result.buckets[i] = buckets[i].load(std::memory_order_relaxed);
+            result.count  = count.load(std::memory_order_relaxed);
+            result.sum_ns = sum_ns.load(std::memory_order_relaxed);
+            result.max_ns = max_ns.load(std::memory_order_relaxed);
+            return result;
+        }
+
+
+        void
+        AtomicHistogram::reset()
+            noexcept
+        {
+            for (auto& b : buckets)
+                b.store(0, std::memory_order_relaxed);
+            count.store(0, std::memory_order_relaxed);
+            sum_ns.store(0, std::memory_order_relaxed);
+            max_ns.store(0, std::memory_order_relaxed);
+        }
+
+
+        Stats
+        StatsCounters::load()
+            const noexcept
+        {
+            Stats result;
+            for (std::size_t i = 0; i < num_operations; ++i)
+                result.calls[i] = calls[i].load(std::memory_order_relaxed);
+            result.devices_materialized = devices_materialized.load(std::memory_order_relaxed);
+            result.events_received      = events_received.load(std::memory_order_relaxed);
+            result.events_filtered      = events_filtered.load(std::memory_order_relaxed);
+            result.events_dropped       = events_dropped.load(std::memory_order_relaxed);
+            result.events_coalesced     = events_coalesced.load(std::memory_order_relaxed);
+            result.events_delivered     = events_delivered.load(std::memory_order_relaxed);
+            result.dispatch_time = dispatch_time.load();
+            result.handler_time  = handler_time.load();
+            return result;
+        }
+
+
+        void
+        StatsCounters::reset()
+            noexcept
+        {
+            for (auto& c : calls)
+                c.store(0, std::memory_order_relaxed);
+            devices_materialized.store(0, std::memory_order_relaxed);
+            events_received.store(0, std::memory_order_relaxed);
+            events_filtered.store(0, std::memory_order_relaxed);
+            events_dropped.store(0, std::memory_order_relaxed);
+            events_coalesced.store(0, std::memory_order_relaxed);
+            events_delivered.store(0, std::memory_order_relaxed);
+            dispatch_time.reset();
+            handler_time.reset();
+        }
+
+    } // namespace detail
+
+
+    namespace stats {
+
+        std::atomic_bool global_enabled = false;
+
+
+        detail::StatsCounters&
+        global()
+            noexcept
+        {
+            static detail::StatsCounters counters;
+            return counters;
+        }
+
+
+        void
+        enable(bool enable)
+            noexcept
+        {
+            global_enabled.store(enable, std::memory_order_relaxed);
+        }
+
+
+        bool
+        is_enabled()
+            noexcept
+        {
+            return global_enabled.load(std::memory_order_relaxed);
+        }
+
+
+        Stats
+        snapshot()
+            noexcept
+        {
+            return global().load();
+        }
+
+
+        void
+        reset()
+            noexcept
+        {
+            global().reset();
+        }
+
+    } // namespace stats
+
+} // namespace gudev
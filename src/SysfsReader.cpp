@@ -0,0 +1,336 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <span>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#ifdef HAVE_LIBURING
+#include <liburing.h>
+#endif
+
+#include "gudevxx/SysfsReader.hpp"
+
+
+namespace gudev {
+
+    namespace {
+
+        // Most sysfs attributes fit in one 4 KiB page; longer ones are finished by read_rest().
+        constexpr std::size_t attr_size = 4096;
+
+
+        struct Job {
+            std::string path;
+            int fd = -1;
+            int result = 0;
+        };
+
+
+        std::vector<Job>
+        make_jobs(std::span<const std::filesystem::path> sysfs_paths,
+                  std::span<const zstring_view> attrs)
+        {
+            std::vector<Job> jobs;
+            jobs.reserve(sysfs_paths.size() * attrs.size());
+            for (auto& p : sysfs_paths)
+                for (auto& a : attrs) {
+                    Job j;
+                    // An empty path fails to open, leaving the value empty.
+                    if (p.empty()) {
+                        jobs.push_back(std::move(j));
+                        continue;
+                    }
+                    j.path.reserve(p.native().size() + 1 + a.view().size());
+                    j.path += p.native();
+                    j.path += '/';
+                    j.path += a.view();
+                    jobs.push_back(std::move(j));
+                }
+            return jobs;
+        }
+
+
+        // Append the rest of a file, starting at `offset`; returns false on errors.
+        bool
+        read_rest(int fd,
+                  off_t offset,
+                  std::string& out)
+        {
+            char chunk[attr_size];
+            for (;;) {
+                ssize_t n = pread(fd, chunk, sizeof chunk, offset);
+                if (n < 0) {
+                    if (errno == EINTR)
+                        continue;
+                    return false;
+                }
+                if (n == 0)
+                    return true;
+                out.append(chunk, n);
+                offset += n;
+            }
+        }
+
+
+        // `len` bytes of `fd` were read into `buf`; a full buffer may not be the whole value.
+        std::optional<std::string>
+        make_value(int fd,
+                   const char* buf,
+                   int len)
+        {
+            if (len < 0)
+                return {};
+            std::string value{buf, static_cast<std::size_t>(len)};
+            if (static_cast<std::size_t>(len) == attr_size && !read_rest(fd, len, value))
+                return {};
+            while (!value.empty() && value.back() == '\n')
+                value.pop_back();
+            return value;
+        }
+
+
+        void
+        read_sync(std::vector<Job>& jobs,
+                  std::size_t first,
+                  std::vector<char>& buf,
+                  std::vector<std::optional<std::string>>& values)
+        {
+            for (std::size_t i = first; i < jobs.size(); ++i) {
+                int fd = open(jobs[i].path.c_str(), O_RDONLY | O_CLOEXEC);
+                if (fd < 0)
+                    continue;
+                ssize_t n;
+                do
+                    n = ::read(fd, buf.data(), attr_size);
+                while (n < 0 && errno == EINTR);
+                values[i] = make_value(fd, buf.data(), n);
+                close(fd);
+            }
+        }
+
+
+        // Closes the files of a batch that are still open, if it's abandoned by an exception.
+        struct BatchGuard {
+
+            std::span<Job> jobs;
+
+
+            ~BatchGuard()
+                noexcept
+            {
+                for (auto& j : jobs)
+                    if (j.fd >= 0) {
+                        close(j.fd);
+                        j.fd = -1;
+                    }
+            }
+
+        }; // struct BatchGuard
+
+    } // namespace
+
+
+    struct SysfsReader::Ring {
+
+#ifdef HAVE_LIBURING
+        io_uring ring;
+
+        explicit
+        Ring(unsigned depth)
+        {
+            int r = io_uring_queue_init(depth, &ring, 0);
+            if (r < 0)
+                throw std::system_error{-r, std::system_category(), "io_uring_queue_init()"};
+        }
+
+
+        ~Ring()
+            noexcept
+        {
+            io_uring_queue_exit(&ring);
+        }
+
+
+        // Submit all prepared entries, and wait for `count` completions.
+        template<typename Func>
+        void
+        complete(unsigned count,
+                 Func on_complete)
+        {
+            // The kernel may take only part of the entries; submit the rest.
+            do {
+                int r = io_uring_submit_and_wait(&ring, count);
+                if (r == -EINTR)
+                    continue;
+                if (r < 0)
+                    throw std::system_error{-r, std::system_category(), "io_uring_submit_and_wait()"};
+                if (r == 0 && io_uring_sq_ready(&ring))
+                    throw std::system_error{EBUSY, std::system_category(), "io_uring_submit_and_wait()"};
+            } while (io_uring_sq_ready(&ring));
+
+            unsigned done = 0;
+            while (done < count) {
+                io_uring_cqe* cqe;
+                int r = io_uring_wait_cqe(&ring, &cqe);
+                if (r == -EINTR)
+                    continue;
+                if (r < 0)
+                    throw std::system_error{-r, std::system_category(), "io_uring_wait_cqe()"};
+                on_complete(cqe->user_data, cqe->res);
+                io_uring_cqe_seen(&ring, cqe);
+                ++done;
+            }
+        }
+
+
+        // Returns how many jobs were done; fewer than all if io_uring failed.
+        std::size_t
+        read(std::vector<Job>& jobs,
+             std::vector<char>& buf,
+             std::vector<std::optional<std::string>>& values,
+             unsigned depth)
+        {
+            for (std::size_t first = 0; first < jobs.size(); first += depth) {
+                const std::size_t last = std::min(jobs.size(), first + depth);
+                const unsigned count = last - first;
+                BatchGuard guard{std::span{jobs}.subspan(first, count)};
+                try {
+                    // Phase 1: open all files in this batch.
+                    for (std::size_t i = first; i < last; ++i) {
+                        auto sqe = io_uring_get_sqe(&ring);
+                        io_uring_prep_openat(sqe, AT_FDCWD, jobs[i].path.c_str(), O_RDONLY | O_CLOEXEC, 0);
+                        sqe->user_data = i;
+                    }
+                    complete(count,
+                             [&](std::uint64_t i, int res)
+                             {
+                                 jobs[i].fd = res;
+                             });
+
+                    // Phase 2: read the files that opened.
+                    unsigned reads = 0;
+                    for (std::size_t i = first; i < last; ++i) {
+                        if (jobs[i].fd < 0)
+                            continue;
+                        auto sqe = io_uring_get_sqe(&ring);
+                        io_uring_prep_read(sqe, jobs[i].fd, buf.data() + (i - first) * attr_size, attr_size, 0);
+                        sqe->user_data = i;
+                        ++reads;
+                    }
+                    complete(reads,
+                             [&](std::uint64_t i, int res)
+                             {
+                                 jobs[i].result = res;
+                             });
+
+                    // Phase 3: close them. The ring owns the fds from here, so a
+                    // failure can't make the guard close them a second time.
+                    unsigned closes = 0;
+                    for (std::size_t i = first; i < last; ++i) {
+                        if (jobs[i].fd < 0)
+                            continue;
+                        values[i] = make_value(jobs[i].fd,
+                                               buf.data() + (i - first) * attr_size,
+                                               jobs[i].result);
+                        auto sqe = io_uring_get_sqe(&ring);
+                        io_uring_prep_close(sqe, jobs[i].fd);
+                        sqe->user_data = i;
+                        jobs[i].fd = -1;
+                        ++closes;
+                    }
+                    complete(closes,
+                             [](std::uint64_t, int) {});
+                }
+                catch (std::system_error&) {
+                    return first;
+                }
+            }
+            return jobs.size();
+        }
+#endif
+
+    }; // struct SysfsReader::Ring
+
+
+    SysfsReader::SysfsReader(unsigned queue_depth) :
+        queue_depth{std::max(queue_depth, 1u)}
+    {
+#ifdef HAVE_LIBURING
+        try {
+            ring = std::make_unique<Ring>(this->queue_depth);
+        }
+        catch (std::system_error&) {
+            // No io_uring (old kernel, or disabled by seccomp): use the synchronous fallback.
+        }
+#endif
+    }
+
+
+    SysfsReader::~SysfsReader()
+        noexcept = default;
+
+
+    bool
+    SysfsReader::uses_io_uring()
+        const noexcept
+    {
+        return bool(ring);
+    }
+
+
+    SysfsAttrTable
+    SysfsReader::read(std::span<const Device> devices,
+                      std::span<const zstring_view> attrs)
+    {
+        std::vector<std::filesystem::path> paths;
+        paths.reserve(devices.size());
+        for (auto& dev : devices)
+            paths.push_back(dev.sysfs().value_or(""));
+        return read(paths, attrs);
+    }
+
+
+    SysfsAttrTable
+    SysfsReader::read(std::span<const std::filesystem::path> sysfs_paths,
+                      std::span<const zstring_view> attrs)
+    {
+        SysfsAttrTable table;
+        table.num_devices = sysfs_paths.size();
+        table.num_attrs = attrs.size();
+        table.values.resize(table.num_devices * table.num_attrs);
+
+        auto jobs = make_jobs(sysfs_paths, attrs);
+        std::size_t done = 0;
+
+#ifdef HAVE_LIBURING
+        if (ring) {
+            std::vector<char> buf(queue_depth * attr_size);
+            done = ring->read(jobs, buf, table.values, queue_depth);
+            if (done == jobs.size())
+                return table;
+            // The ring failed mid-batch; finish with plain reads, and don't use it again.
+            ring.reset();
+        }
+#endif
+
+        std::vector<char> buf(attr_size);
+        read_sync(jobs, done, buf, table.values);
+        return table;
+    }
+
+} // namespace gudev
@@ -0,0 +1,414 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <algorithm>
+#include <climits>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <fnmatch.h>
+
+#include "gudevxx/SysfsWalker.hpp"
+
+#include "gudevxx/Enumerator.hpp"
+
+#include "dirent.hpp"
+
+
+namespace gudev {
+
+    namespace {
+
+        bool
+        glob_match_any(const std::vector<std::string>& patterns,
+                       const char* value)
+        {
+            return std::ranges::any_of(patterns,
+                                       [value](const std::string& p)
+                                       {
+                                           return fnmatch(p.c_str(), value, 0) == 0;
+                                       });
+        }
+
+
+        // Read a link relative to `dirfd`; returns false if it's not a link.
+        bool
+        read_link(int dirfd,
+                  const char* name,
+                  std::string& target)
+        {
+            char buf[PATH_MAX];
+            ssize_t n = readlinkat(dirfd, name, buf, sizeof buf);
+            if (n < 0 || std::size_t(n) == sizeof buf)
+                return false;
+            target.assign(buf, n);
+            return true;
+        }
+
+
+        // Read a sysfs attribute, without the trailing newline.
+        bool
+        read_attr(int devfd,
+                  const std::string& key,
+                  std::string& value)
+        {
+            detail::unique_fd fd{openat(devfd, key.c_str(), O_RDONLY | O_CLOEXEC)};
+            if (!fd)
+                return false;
+            char buf[4096];
+            ssize_t n;
+            do
+                n = read(fd.get(), buf, sizeof buf);
+            while (n < 0 && errno == EINTR);
+            if (n < 0)
+                return false;
+            value.assign(buf, n);
+            while (!value.empty() && value.back() == '\n')
+                value.pop_back();
+            return true;
+        }
+
+
+        /// Lexically apply a relative link target to a directory.
+        void
+        resolve(std::string& out,
+                std::string_view base,
+                std::string_view target)
+        {
+            out.assign(base);
+            while (!target.empty()) {
+                auto slash = std::min(target.find('/'), target.size());
+                std::string_view comp = target.substr(0, slash);
+                target.remove_prefix(std::min(slash + 1, target.size()));
+                if (comp.empty() || comp == ".")
+                    continue;
+                if (comp == "..") {
+                    auto last = out.rfind('/');
+                    out.resize(last == std::string::npos ? 0 : last);
+                    continue;
+                }
+                out += '/';
+                out += comp;
+            }
+        }
+
+
+        struct Walk {
+
+            const MatchRules& rules;
+            const SysfsWalker::visitor& visit;
+            std::size_t visited = 0;
+            bool stopped = false;
+            std::vector<bool> explicit_seen;
+            // Subsystems listed in class/ or bus/, already walked or excluded.
+            std::set<std::string, std::less<>> known;
+            std::string path;
+            std::string scratch;
+
+
+            Walk(const MatchRules& rules,
+                 const SysfsWalker::visitor& visit) :
+                rules{rules},
+                visit{visit},
+                explicit_seen(rules.sysfs_paths.size())
+            {}
+
+
+            bool
+            subsystem_allowed(const char* subsystem)
+                const
+            {
+                if (!rules.subsystems.empty() && !glob_match_any(rules.subsystems, subsystem))
+                    return false;
+                return !glob_match_any(rules.nomatch_subsystems, subsystem);
+            }
+
+
+            bool
+            attrs_match(int dirfd,
+                        const char* name)
+            {
+                if (rules.sysfs_attrs.empty() && rules.nomatch_sysfs_attrs.empty())
+                    return true;
+                auto devfd = detail::open_dir(dirfd, name);
+                if (!devfd)
+                    return false;
+                // All sysfs attributes must match, none of the excluded ones may match.
+                for (auto& [key, pattern] : rules.sysfs_attrs)
+                    if (!read_attr(devfd.get(), key, scratch)
+                        || fnmatch(pattern.c_str(), scratch.c_str(), 0) != 0)
+                        return false;
+                for (auto& [key, pattern] : rules.nomatch_sysfs_attrs)
+                    if (read_attr(devfd.get(), key, scratch)
+                        && fnmatch(pattern.c_str(), scratch.c_str(), 0) == 0)
+                        return false;
+                return true;
+            }
+
+
+            void
+            emit(std::string_view p)
+            {
+                for (std::size_t i = 0; i < explicit_seen.size(); ++i)
+                    if (rules.sysfs_paths[i].native() == p)
+                        explicit_seen[i] = true;
+                ++visited;
+                if (!visit(p))
+                    stopped = true;
+            }
+
+
+            /// Resolve an entry of `dirfd` (listed as `base`) to its device path.
+            bool
+            resolve_entry(int dirfd,
+                          std::string_view base,
+                          const char* name,
+                          unsigned char type)
+            {
+                if ((type == DT_LNK || type == DT_UNKNOWN)
+                    && read_link(dirfd, name, scratch)) {
+                    resolve(path, base, scratch);
+                    return true;
+                }
+                // Old layouts had real directories under class/.
+                if (type == DT_DIR || type == DT_UNKNOWN) {
+                    resolve(path, base, name);
+                    return true;
+                }
+                return false;
+            }
+
+
+            /// Walk a directory holding the devices of a single subsystem.
+            void
+            walk_subsystem(int dirfd,
+                           const std::string& base)
+            {
+                detail::for_each_dirent(dirfd,
+                                        [&](std::string_view name, unsigned char type)
+                                        {
+                                            const char* cname = name.data();
+                                            if (!rules.names.empty()
+                                                && !glob_match_any(rules.names, cname))
+                                                return true;
+                                            if (!resolve_entry(dirfd, base, cname, type))
+                                                return true;
+                                            if (!attrs_match(dirfd, cname))
+                                                return true;
+                                            emit(path);
+                                            return !stopped;
+                                        });
+            }
+
+
+            void
+            walk_class(int rootfd,
+                       const std::string& root)
+            {
+                auto classfd = detail::open_dir(rootfd, "class");
+                if (!classfd)
+                    return;
+                detail::for_each_dirent(classfd.get(),
+                                        [&](std::string_view subsystem, unsigned char)
+                                        {
+                                            known.emplace(subsystem);
+                                            if (!subsystem_allowed(subsystem.data()))
+                                                return true;
+                                            auto fd = detail::open_dir(classfd.get(), subsystem.data());
+                                            if (fd)
+                                                walk_subsystem(fd.get(),
+                                                               root + "/class/" + std::string{subsystem});
+                                            return !stopped;
+                                        });
+            }
+
+
+            void
+            walk_bus(int rootfd,
+                     const std::string& root)
+            {
+                auto busfd = detail::open_dir(rootfd, "bus");
+                if (!busfd)
+                    return;
+                detail::for_each_dirent(busfd.get(),
+                                        [&](std::string_view subsystem, unsigned char)
+                                        {
+                                            known.emplace(subsystem);
+                                            if (!subsystem_allowed(subsystem.data()))
+                                                return true;
+                                            const std::string devices = std::string{subsystem} + "/devices";
+                                            auto fd = detail::open_dir(busfd.get(), devices.c_str());
+                                            if (fd)
+                                                walk_subsystem(fd.get(), root + "/bus/" + devices);
+                                            return !stopped;
+                                        });
+            }
+
+
+            /*
+             * Every device in dev/ is normally reachable from class/ or bus/ too;
+             * only those whose subsystem was not listed there are reported.
+             */
+            void
+            walk_dev(int rootfd,
+                     const std::string& root,
+                     const char* kind)
+            {
+                const std::string dir = std::string{"dev/"} + kind;
+                auto devfd = detail::open_dir(rootfd, dir.c_str());
+                if (!devfd)
+                    return;
+                const std::string base = root + "/" + dir;
+                std::string link;
+                detail::for_each_dirent(devfd.get(),
+                                        [&](std::string_view name, unsigned char type)
+                                        {
+                                            link.assign(name);
+                                            link += "/subsystem";
+                                            if (!read_link(devfd.get(), link.c_str(), scratch))
+                                                return true;
+                                            const std::string subsystem = scratch.substr(scratch.rfind('/') + 1);
+                                            if (known.contains(subsystem)
+                                                || !subsystem_allowed(subsystem.c_str()))
+                                                return true;
+                                            if (!resolve_entry(devfd.get(), base, name.data(), type))
+                                                return true;
+                                            const char* sysname = path.c_str() + path.rfind('/') + 1;
+                                            if (!rules.names.empty()
+                                                && !glob_match_any(rules.names, sysname))
+                                                return true;
+                                            if (!attrs_match(devfd.get(), name.data()))
+                                                return true;
+                                            emit(path);
+                                            return !stopped;
+                                        });
+            }
+
+
+            void
+            add_explicit()
+            {
+                // Same as libudev: explicit paths are reported whenever they exist.
+                for (std::size_t i = 0; i < explicit_seen.size() && !stopped; ++i) {
+                    if (explicit_seen[i])
+                        continue;
+                    auto& p = rules.sysfs_paths[i];
+                    if (access(p.c_str(), F_OK) == 0)
+                        emit(p.native());
+                }
+            }
+
+        }; // struct Walk
+
+    } // namespace
+
+
+    SysfsWalker::SysfsWalker(MatchRules rules,
+                             std::filesystem::path sysfs_root) :
+        match_rules{std::move(rules)},
+        root{std::move(sysfs_root)}
+    {
+        if (!match_rules.properties.empty()
+            || !match_rules.tags.empty()
+            || match_rules.initialized)
+            throw std::invalid_argument{"SysfsWalker: property, tag and initialized rules"
+                                        " need the udev database"};
+    }
+
+
+    SysfsWalker::SysfsWalker(const Enumerator& etor,
+                             std::filesystem::path sysfs_root) :
+        SysfsWalker{etor.rules(), std::move(sysfs_root)}
+    {}
+
+
+    const MatchRules&
+    SysfsWalker::rules()
+        const noexcept
+    {
+        return match_rules;
+    }
+
+
+    const std::filesystem::path&
+    SysfsWalker::sysfs_root()
+        const noexcept
+    {
+        return root;
+    }
+
+
+    std::size_t
+    SysfsWalker::for_each(const visitor& visit)
+        const
+    {
+        auto rootfd = detail::open_dir(AT_FDCWD, root.c_str());
+        if (!rootfd)
+            throw std::system_error{errno, std::system_category(), "open(" + root.string() + ")"};
+
+        std::string root_str = root.lexically_normal().string();
+        while (root_str.size() > 1 && root_str.back() == '/')
+            root_str.pop_back();
+
+        Walk walk{match_rules, visit};
+        walk.walk_class(rootfd.get(), root_str);
+        if (!walk.stopped)
+            walk.walk_bus(rootfd.get(), root_str);
+        if (!walk.stopped)
+            walk.walk_dev(rootfd.get(), root_str, "block");
+        if (!walk.stopped)
+            walk.walk_dev(rootfd.get(), root_str, "char");
+        walk.add_explicit();
+        return walk.visited;
+    }
+
+
+    std::vector<std::filesystem::path>
+    SysfsWalker::paths()
+        const
+    {
+        std::vector<std::filesystem::path> result;
+        for_each([&result](std::string_view p)
+                 {
+                     result.emplace_back(p);
+                     return true;
+                 });
+        return result;
+    }
+
+
+    std::size_t
+    SysfsWalker::count(std::size_t limit)
+        const
+    {
+        if (!limit)
+            return 0;
+        return for_each([limit, n = std::size_t{0}](std::string_view) mutable
+                        {
+                            return ++n < limit;
+                        });
+    }
+
+
+    std::vector<Device>
+    SysfsWalker::devices(Client& client)
+        const
+    {
+        std::vector<Device> result;
+        for_each([&](std::string_view p)
+                 {
+                     if (auto dev = client.get_sysfs(std::filesystem::path{p}))
+                         result.push_back(std::move(*dev));
+                     return true;
+                 });
+        return result;
+    }
+
+} // namespace gudev
@@ -0,0 +1,344 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <algorithm>
+#include <charconv>
+#include <system_error>
+
+#include <sys/sysmacros.h>
+
+#include "gudevxx/UdevDatabase.hpp"
+
+#include "dirent.hpp"
+
+
+namespace gudev {
+
+    namespace {
+
+        struct Pending {
+            std::size_t name_begin;
+            std::size_t name_size;
+            std::size_t data_begin;
+            std::size_t data_size;
+        };
+
+
+        struct Ranges {
+            std::size_t properties_begin;
+            std::size_t strings_begin;
+            std::size_t num_tags = 0;
+            std::size_t num_current_tags = 0;
+            std::size_t num_symlinks = 0;
+        };
+
+
+        // Append the whole file to `text`; returns false if it can't be read.
+        bool
+        read_into(int fd,
+                  std::vector<char>& text)
+        {
+            const std::size_t start = text.size();
+            std::size_t used = start;
+            for (;;) {
+                if (text.size() - used < 4096)
+                    text.resize(used + 4096);
+                ssize_t r = read(fd, text.data() + used, text.size() - used);
+                if (r < 0) {
+                    if (errno == EINTR)
+                        continue;
+                    text.resize(start);
+                    return false;
+                }
+                if (r == 0)
+                    break;
+                used += r;
+            }
+            text.resize(used);
+            return true;
+        }
+
+    } // namespace
+
+
+    std::optional<std::string_view>
+    UdevDatabase::Record::property(std::string_view key)
+        const noexcept
+    {
+        auto it = std::ranges::lower_bound(properties, key, {}, &Property::key);
+        if (it == properties.end() || it->key != key)
+            return {};
+        return it->value;
+    }
+
+
+    bool
+    UdevDatabase::Record::has_tag(std::string_view tag)
+        const noexcept
+    {
+        return std::ranges::find(tags, tag) != tags.end();
+    }
+
+
+    UdevDatabase::UdevDatabase(std::filesystem::path data_dir) :
+        dir{std::move(data_dir)}
+    {}
+
+
+    UdevDatabase::UdevDatabase(UdevDatabase&& other)
+        noexcept = default;
+
+
+    UdevDatabase&
+    UdevDatabase::operator =(UdevDatabase&& other)
+        noexcept = default;
+
+
+    const std::filesystem::path&
+    UdevDatabase::data_dir()
+        const noexcept
+    {
+        return dir;
+    }
+
+
+    void
+    UdevDatabase::load()
+    {
+        text.clear();
+        table.clear();
+        all_properties.clear();
+        all_strings.clear();
+
+        auto dirfd = detail::open_dir(AT_FDCWD, dir.c_str());
+        if (!dirfd)
+            throw std::system_error{errno, std::system_category(), "open(" + dir.string() + ")"};
+
+        // Read everything first, so the buffer stops moving before any view is taken.
+        std::vector<Pending> pending;
+        detail::for_each_dirent(dirfd.get(),
+                                [&](std::string_view name, unsigned char type)
+                                {
+                                    // udev writes records to hidden temporary files first.
+                                    if (name.front() == '.')
+                                        return true;
+                                    if (type != DT_REG && type != DT_UNKNOWN)
+                                        return true;
+                                    detail::unique_fd fd{openat(dirfd.get(),
+                                                                name.data(),
+                                                                O_RDONLY | O_CLOEXEC | O_NOFOLLOW)};
+                                    // The record may be gone already.
+                                    if (!fd)
+                                        return true;
+                                    Pending p;
+                                    p.name_begin = text.size();
+                                    p.name_size = name.size();
+                                    text.insert(text.end(), name.begin(), name.end());
+                                    p.data_begin = text.size();
+                                    if (!read_into(fd.get(), text)) {
+                                        text.resize(p.name_begin);
+                                        return true;
+                                    }
+                                    p.data_size = text.size() - p.data_begin;
+                                    pending.push_back(p);
+                                    return true;
+                                });
+
+        std::vector<Ranges> ranges;
+        ranges.reserve(pending.size());
+        table.resize(pending.size());
+        std::vector<std::string_view> tags;
+        std::vector<std::string_view> current_tags;
+        std::vector<std::string_view> symlinks;
+
+        for (std::size_t i = 0; i < pending.size(); ++i) {
+            const Pending& p = pending[i];
+            Record& rec = table[i];
+            rec.id = {text.data() + p.name_begin, p.name_size};
+
+            Ranges& rg = ranges.emplace_back();
+            rg.properties_begin = all_properties.size();
+            tags.clear();
+            current_tags.clear();
+            symlinks.clear();
+
+            std::string_view data{text.data() + p.data_begin, p.data_size};
+            while (!data.empty()) {
+                auto eol = std::min(data.find('\n'), data.size());
+                std::string_view line = data.substr(0, eol);
+                data.remove_prefix(std::min(eol + 1, data.size()));
+                if (line.size() < 2 || line[1] != ':')
+                    continue;
+                std::string_view arg = line.substr(2);
+                switch (line[0]) {
+                    case 'E': {
+                        auto eq = arg.find('=');
+                        if (eq == std::string_view::npos)
+                            break;
+                        all_properties.push_back({arg.substr(0, eq), arg.substr(eq + 1)});
+                        break;
+                    }
+                    case 'G':
+                        tags.push_back(arg);
+                        break;
+                    case 'Q':
+                        current_tags.push_back(arg);
+                        break;
+                    case 'S':
+                        symlinks.push_back(arg);
+                        break;
+                    case 'I': {
+                        std::uint64_t usec;
+                        auto [ptr, ec] = std::from_chars(arg.data(), arg.data() + arg.size(), usec);
+                        if (ec == std::errc{})
+                            rec.usec_initialized = usec;
+                        break;
+                    }
+                    case 'L':
+                        std::from_chars(arg.data(), arg.data() + arg.size(), rec.devlink_priority);
+                        break;
+                }
+            }
+
+            std::sort(all_properties.begin() + rg.properties_begin, all_properties.end(),
+                      [](const Property& a, const Property& b)
+                      {
+                          return a.key < b.key;
+                      });
+
+            rg.strings_begin = all_strings.size();
+            rg.num_tags = tags.size();
+            rg.num_current_tags = current_tags.size();
+            rg.num_symlinks = symlinks.size();
+            all_strings.insert(all_strings.end(), tags.begin(), tags.end());
+            all_strings.insert(all_strings.end(), current_tags.begin(), current_tags.end());
+            all_strings.insert(all_strings.end(), symlinks.begin(), symlinks.end());
+        }
+
+        // The property and string arrays are complete, so spans can be taken now.
+        for (std::size_t i = 0; i < table.size(); ++i) {
+            Record& rec = table[i];
+            const Ranges& rg = ranges[i];
+            const std::size_t properties_end = i + 1 < ranges.size()
+                ? ranges[i + 1].properties_begin
+                : all_properties.size();
+            rec.properties = std::span{all_properties}.subspan(rg.properties_begin,
+                                                               properties_end - rg.properties_begin);
+            auto strings = std::span{all_strings}.subspan(rg.strings_begin);
+            rec.tags = strings.first(rg.num_tags);
+            strings = strings.subspan(rg.num_tags);
+            rec.current_tags = strings.first(rg.num_current_tags);
+            strings = strings.subspan(rg.num_current_tags);
+            rec.symlinks = strings.first(rg.num_symlinks);
+        }
+
+        std::ranges::sort(table, {}, &Record::id);
+    }
+
+
+    std::size_t
+    UdevDatabase::size()
+        const noexcept
+    {
+        return table.size();
+    }
+
+
+    bool
+    UdevDatabase::empty()
+        const noexcept
+    {
+        return table.empty();
+    }
+
+
+    std::span<const UdevDatabase::Record>
+    UdevDatabase::records()
+        const noexcept
+    {
+        return table;
+    }
+
+
+    const UdevDatabase::Record*
+    UdevDatabase::find(std::string_view id)
+        const noexcept
+    {
+        auto it = std::ranges::lower_bound(table, id, {}, &Record::id);
+        if (it == table.end() || it->id != id)
+            return nullptr;
+        return &*it;
+    }
+
+
+    const UdevDatabase::Record*
+    UdevDatabase::find(const Device& device)
+        const
+    {
+        auto id = device_id(device);
+        if (id.empty())
+            return nullptr;
+        return find(id);
+    }
+
+
+    std::vector<UdevDatabase::Match>
+    UdevDatabase::find_property(std::string_view key)
+        const
+    {
+        std::vector<Match> result;
+        for (auto& rec : table)
+            if (auto val = rec.property(key))
+                result.push_back({rec.id, *val});
+        return result;
+    }
+
+
+    std::vector<std::optional<std::string_view>>
+    UdevDatabase::property(std::span<const std::string_view> ids,
+                           std::string_view key)
+        const
+    {
+        std::vector<std::optional<std::string_view>> result;
+        result.reserve(ids.size());
+        for (auto id : ids) {
+            auto rec = find(id);
+            result.push_back(rec ? rec->property(key) : std::nullopt);
+        }
+        return result;
+    }
+
+
+    std::string
+    UdevDatabase::device_id(const Device& device)
+    {
+        // Same scheme as libudev's udev_device_get_device_id().
+        auto type = device.type();
+        auto devnum = device.device_number();
+        if (devnum && *devnum && type != Device::Type::no_device) {
+            char kind = type == Device::Type::block_device ? 'b' : 'c';
+            return kind
+                + std::to_string(major(*devnum))
+                + ":"
+                + std::to_string(minor(*devnum));
+        }
+
+        auto subsystem = device.subsystem();
+        if (!subsystem)
+            return {};
+
+        if (*subsystem == "net")
+            if (auto ifindex = device.property("IFINDEX"); ifindex && *ifindex != "0")
+                return "n" + *ifindex;
+
+        auto name = device.name();
+        if (!name)
+            return {};
+        return "+" + *subsystem + ":" + *name;
+    }
+
+} // namespace gudev
@@ -0,0 +1,158 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef LIBGUDEVXX_DIRENT_HPP
+#define LIBGUDEVXX_DIRENT_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+
+namespace gudev::detail {
+
+    /// Owning file descriptor.
+    class unique_fd {
+
+        int fd = -1;
+
+    public:
+
+        unique_fd()
+            noexcept = default;
+
+        explicit
+        unique_fd(int fd)
+            noexcept :
+            fd{fd}
+        {}
+
+        unique_fd(unique_fd&& other)
+            noexcept :
+            fd{std::exchange(other.fd, -1)}
+        {}
+
+        unique_fd&
+        operator =(unique_fd&& other)
+            noexcept
+        {
+            if (this != &other) {
+                reset();
+                fd = std::exchange(other.fd, -1);
+            }
+            return *this;
+        }
+
+        ~unique_fd()
+            noexcept
+        {
+            reset();
+        }
+
+
+        void
+        reset()
+            noexcept
+        {
+            if (fd >= 0)
+                close(fd);
+            fd = -1;
+        }
+
+
+        int
+        get()
+            const noexcept
+        {
+            return fd;
+        }
+
+
+        /// Give up ownership.
+        int
+        release()
+            noexcept
+        {
+            return std::exchange(fd, -1);
+        }
+
+
+        explicit
+        operator bool()
+            const noexcept
+        {
+            return fd >= 0;
+        }
+
+    }; // class unique_fd
+
+
+    /// Open a directory relative to `dirfd`; returns an invalid fd on failure.
+    inline
+    unique_fd
+    open_dir(int dirfd,
+             const char* path)
+        noexcept
+    {
+        return unique_fd{openat(dirfd, path, O_RDONLY | O_DIRECTORY | O_CLOEXEC)};
+    }
+
+
+    /**
+     * Call `func(name, d_type)` for each entry of the directory, except "." and
+     * "..", until it returns false. Entries are read in large batches with
+     * getdents64(), bypassing readdir()'s allocations.
+     *
+     * Returns false if stopped early; throws `std::system_error` on errors.
+     */
+    template<typename Func>
+    bool
+    for_each_dirent(int dirfd,
+                    Func&& func)
+    {
+        // struct linux_dirent64 isn't exposed by libc; the layout is fixed by the kernel ABI:
+        // u64 d_ino, s64 d_off, u16 d_reclen, u8 d_type, char d_name[].
+        constexpr std::size_t reclen_offset = 16;
+        constexpr std::size_t type_offset = 18;
+        constexpr std::size_t name_offset = 19;
+
+        alignas(8) char buf[32768];
+        for (;;) {
+            long n = syscall(SYS_getdents64, dirfd, buf, sizeof buf);
+            if (n < 0) {
+                if (errno == EINTR)
+                    continue;
+                throw std::system_error{errno, std::system_category(), "getdents64()"};
+            }
+            if (n == 0)
+                return true;
+
+            for (long pos = 0; pos < n;) {
+                unsigned short reclen;
+                std::memcpy(&reclen, buf + pos + reclen_offset, sizeof reclen);
+                const unsigned char type = buf[pos + type_offset];
+                const std::string_view name{buf + pos + name_offset};
+                pos += reclen;
+                if (name == "." || name == "..")
+                    continue;
+                if (!func(name, type))
+                    return false;
+            }
+        }
+    }
+
+} // namespace gudev::detail
+
+#endif
@@ -0,0 +1,56 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef LIBGUDEVXX_PROBES_HPP
+#define LIBGUDEVXX_PROBES_HPP
+
+/*
+ * USDT probes, under the provider "libgudevxx".
+ *
+ * These are only compiled in with `./configure --enable-usdt`; otherwise
+ * GUDEVXX_PROBE() expands to nothing. List them with:
+ *
+ *     perf list 'sdt_libgudevxx:*'
+ *     bpftrace -l 'usdt:/path/to/libgudevxx.so:*'
+ *
+ * Probes and arguments:
+ *
+ *   query__entry         (subsystem)
+ *   query__return        (subsystem, num_devices)
+ *   get__entry           (key1, key2)
+ *   get__return          (key1, key2, found)
+ *   get_devnum__entry    (type, number)
+ *   get_devnum__return   (type, number, found)
+ *   enumerate__entry     ()
+ *   enumerate__return    (num_devices)
+ *   sysfs_attr__entry    (sysfs_path, key)
+ *   sysfs_attr__return   (sysfs_path, key, found)
+ *   dispatch__entry      (seqnum, action, subsystem)
+ *   dispatch__return     (seqnum, action, subsystem, delivered)
+ *
+ * String arguments are `const char*`, and may be null. For get() by
+ * subsystem and name, key1 and key2 are the subsystem and name; for the other
+ * get() variants, key1 is the path and key2 is null.
+ */
+
+#ifdef HAVE_CONFIG_H
+#include "config.h"
+#endif
+
+#ifdef ENABLE_USDT
+
+#include <sys/sdt.h>
+
+#define GUDEVXX_PROBE(name, ...) STAP_PROBEV(libgudevxx, name __VA_OPT__(,) __VA_ARGS__)
+
+#else
+
+#define GUDEVXX_PROBE(name, ...) do {} while (0)
+
+#endif
+
+#endif
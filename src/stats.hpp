@@ -0,0 +1,109 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef LIBGUDEVXX_STATS_IMPL_HPP
+#define LIBGUDEVXX_STATS_IMPL_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "gudevxx/Stats.hpp"
+
+
+namespace gudev::stats {
+
+    extern std::atomic_bool global_enabled;
+
+    detail::StatsCounters&
+    global()
+        noexcept;
+
+
+    inline
+    bool
+    active(const detail::StatsCounters* local = nullptr)
+        noexcept
+    {
+        return local || global_enabled.load(std::memory_order_relaxed);
+    }
+
+
+    inline
+    void
+    add(std::atomic_uint64_t detail::StatsCounters::* field,
+        std::uint64_t n = 1,
+        detail::StatsCounters* local = nullptr)
+        noexcept
+    {
+        if (global_enabled.load(std::memory_order_relaxed))
+            (global().*field).fetch_add(n, std::memory_order_relaxed);
+        if (local)
+            (local->*field).fetch_add(n, std::memory_order_relaxed);
+    }
+
+
+    inline
+    void
+    count(Operation op,
+          detail::StatsCounters* local = nullptr)
+        noexcept
+    {
+        auto idx = static_cast<unsigned>(op);
+        if (global_enabled.load(std::memory_order_relaxed))
+            global().calls[idx].fetch_add(1, std::memory_order_relaxed);
+        if (local)
+            local->calls[idx].fetch_add(1, std::memory_order_relaxed);
+    }
+
+
+    inline
+    void
+    record(detail::AtomicHistogram detail::StatsCounters::* field,
+           std::chrono::nanoseconds t,
+           detail::StatsCounters* local = nullptr)
+        noexcept
+    {
+        if (global_enabled.load(std::memory_order_relaxed))
+            (global().*field).record(t);
+        if (local)
+            (local->*field).record(t);
+    }
+
+
+    /// Measures time only if stats are active when constructed.
+    class Timer {
+
+        std::chrono::steady_clock::time_point start;
+        bool running;
+
+    public:
+
+        explicit
+        Timer(bool run)
+            noexcept :
+            running{run}
+        {
+            if (running)
+                start = std::chrono::steady_clock::now();
+        }
+
+
+        std::chrono::nanoseconds
+        elapsed()
+            const noexcept
+        {
+            if (!running)
+                return {};
+            return std::chrono::steady_clock::now() - start;
+        }
+
+    }; // class Timer
+
+} // namespace gudev::stats
+
+#endif
@@ -0,0 +1,161 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+#include "sysfs_trie.hpp"
+
+
+namespace gudev::detail {
+
+    namespace {
+
+        std::vector<std::string>
+        split(std::string_view path)
+        {
+            std::vector<std::string> result;
+            std::string_view comp;
+            while (SysfsTrie::next_component(path, comp))
+                result.emplace_back(comp);
+            return result;
+        }
+
+    } // namespace
+
+
+    bool
+    SysfsTrie::next_component(std::string_view& rest,
+                              std::string_view& comp)
+        noexcept
+    {
+        while (!rest.empty() && rest.front() == '/')
+            rest.remove_prefix(1);
+        if (rest.empty())
+            return false;
+        auto end = std::min(rest.find('/'), rest.size());
+        comp = rest.substr(0, end);
+        rest.remove_prefix(end);
+        return true;
+    }
+
+
+    void
+    SysfsTrie::insert(std::string_view prefix,
+                      std::uint64_t id)
+    {
+        const auto comps = split(prefix);
+        Node* node = &root;
+        std::size_t pos = 0;
+
+        while (pos < comps.size()) {
+            auto it = node->children.find(comps[pos]);
+            if (it == node->children.end()) {
+                auto leaf = std::make_unique<Node>();
+                leaf->label.assign(comps.begin() + pos, comps.end());
+                leaf->ids.push_back(id);
+                node->children.emplace(comps[pos], std::move(leaf));
+                ++num_ids;
+                return;
+            }
+
+            Node* child = it->second.get();
+            auto label_it = std::mismatch(child->label.begin(), child->label.end(),
+                                          comps.begin() + pos, comps.end()).first;
+            const std::size_t common = label_it - child->label.begin();
+
+            if (common < child->label.size()) {
+                // Split the edge where the labels diverge.
+                auto middle = std::make_unique<Node>();
+                middle->label.assign(child->label.begin(), label_it);
+                child->label.erase(child->label.begin(), label_it);
+                std::string key = child->label.front();
+                middle->children.emplace(std::move(key), std::move(it->second));
+                it->second = std::move(middle);
+                child = it->second.get();
+            }
+
+            node = child;
+            pos += common;
+        }
+
+        node->ids.push_back(id);
+        ++num_ids;
+    }
+
+
+    bool
+    SysfsTrie::erase(std::string_view prefix,
+                     std::uint64_t id)
+    {
+        const auto comps = split(prefix);
+        // Nodes along the path, to prune on the way back.
+        std::vector<Node*> trail{&root};
+        Node* node = &root;
+        std::size_t pos = 0;
+
+        while (pos < comps.size()) {
+            auto it = node->children.find(comps[pos]);
+            if (it == node->children.end())
+                return false;
+            Node* child = it->second.get();
+            if (comps.size() - pos < child->label.size()
+                || !std::equal(child->label.begin(), child->label.end(),
+                               comps.begin() + pos))
+                return false;
+            pos += child->label.size();
+            node = child;
+            trail.push_back(node);
+        }
+
+        auto found = std::ranges::find(node->ids, id);
+        if (found == node->ids.end())
+            return false;
+        node->ids.erase(found);
+        --num_ids;
+
+        // Remove empty leaves, and merge nodes left with a single child.
+        for (std::size_t depth = trail.size() - 1; depth > 0; --depth) {
+            Node* current = trail[depth];
+            Node* parent = trail[depth - 1];
+            if (!current->ids.empty())
+                break;
+            if (current->children.empty()) {
+                parent->children.erase(current->label.front());
+                continue;
+            }
+            if (current->children.size() == 1) {
+                auto only = std::move(current->children.begin()->second);
+                current->children.clear();
+                std::ranges::move(only->label, std::back_inserter(current->label));
+                current->children = std::move(only->children);
+                current->ids = std::move(only->ids);
+            }
+            break;
+        }
+
+        return true;
+    }
+
+
+    bool
+    SysfsTrie::empty()
+        const noexcept
+    {
+        return num_ids == 0;
+    }
+
+
+    std::size_t
+    SysfsTrie::size()
+        const noexcept
+    {
+        return num_ids;
+    }
+
+} // namespace gudev::detail
@@ -0,0 +1,100 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef LIBGUDEVXX_SYSFS_TRIE_HPP
+#define LIBGUDEVXX_SYSFS_TRIE_HPP
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+namespace gudev::detail {
+
+    /**
+     * Compressed radix trie over sysfs path components.
+     *
+     * Each edge holds a run of components, so chains without branches take
+     * a single node. Lookups walk the path once, and report every id whose
+     * prefix ends on a component boundary of the path.
+     */
+    class SysfsTrie {
+
+        struct Node {
+            // Components on the edge from the parent; empty only for the root.
+            std::vector<std::string> label;
+            // Keyed by the first component of each child's label.
+            std::map<std::string, std::unique_ptr<Node>, std::less<>> children;
+            std::vector<std::uint64_t> ids;
+        };
+
+        Node root;
+        std::size_t num_ids = 0;
+
+    public:
+
+        void
+        insert(std::string_view prefix,
+               std::uint64_t id);
+
+        /// Returns false if `id` was not stored under `prefix`.
+        bool
+        erase(std::string_view prefix,
+              std::uint64_t id);
+
+        bool
+        empty()
+            const noexcept;
+
+        std::size_t
+        size()
+            const noexcept;
+
+
+        /// Call `func(id)` for every prefix of `path`, from the shallowest one.
+        template<typename Func>
+        void
+        for_each_prefix(std::string_view path,
+                        Func&& func)
+            const
+        {
+            const Node* node = &root;
+            for (auto id : node->ids)
+                func(id);
+
+            std::string_view rest = path;
+            std::string_view comp;
+            while (next_component(rest, comp)) {
+                auto it = node->children.find(comp);
+                if (it == node->children.end())
+                    return;
+                const Node* child = it->second.get();
+                for (std::size_t i = 1; i < child->label.size(); ++i)
+                    if (!next_component(rest, comp) || comp != child->label[i])
+                        return;
+                node = child;
+                for (auto id : node->ids)
+                    func(id);
+            }
+        }
+
+
+        /// Pop the next non-empty component from `rest`; returns false at the end.
+        static
+        bool
+        next_component(std::string_view& rest,
+                       std::string_view& comp)
+            noexcept;
+
+    }; // class SysfsTrie
+
+} // namespace gudev::detail
+
+#endif
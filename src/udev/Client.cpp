@@ -0,0 +1,102 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <stdexcept>
+
+#include <sys/stat.h>
+
+#include "gudevxx/udev/Client.hpp"
+
+#include "gudevxx/udev/Enumerator.hpp"
+
+
+namespace gudev::udev {
+
+    Client::Client()
+    {
+        create();
+    }
+
+
+    Client::Client(std::nullptr_t)
+        noexcept
+    {}
+
+
+    void
+    Client::create()
+    {
+        auto ptr = udev_new();
+        if (!ptr)
+            throw std::runtime_error{"Could not create new udev context"};
+        destroy();
+        acquire(ptr);
+    }
+
+
+    std::vector<Device>
+    Client::query(zstring_view subsystem)
+    {
+        Enumerator etor{*this};
+        if (!subsystem.empty())
+            etor.match_subsystem(subsystem);
+        return etor.execute();
+    }
+
+
+    std::optional<Device>
+    Client::get(zstring_view subsystem,
+                zstring_view name)
+    {
+        auto d = udev_device_new_from_subsystem_sysname(raw,
+                                                        subsystem.c_str(),
+                                                        name.c_str());
+        if (d)
+            return Device::make_owner(d);
+        return {};
+    }
+
+
+    std::optional<Device>
+    Client::get(Device::Type type,
+                std::uint64_t number)
+    {
+        if (type == Device::Type::no_device)
+            return {};
+        auto d = udev_device_new_from_devnum(raw,
+                                             static_cast<char>(type),
+                                             number);
+        if (d)
+            return Device::make_owner(d);
+        return {};
+    }
+
+
+    std::optional<Device>
+    Client::get(const std::filesystem::path& device_path)
+    {
+        struct stat st;
+        if (stat(device_path.c_str(), &st) != 0)
+            return {};
+        if (S_ISBLK(st.st_mode))
+            return get(Device::Type::block_device, st.st_rdev);
+        if (S_ISCHR(st.st_mode))
+            return get(Device::Type::char_device, st.st_rdev);
+        return {};
+    }
+
+
+    std::optional<Device>
+    Client::get_sysfs(const std::filesystem::path& sysfs_path)
+    {
+        auto d = udev_device_new_from_syspath(raw, sysfs_path.c_str());
+        if (d)
+            return Device::make_owner(d);
+        return {};
+    }
+
+} // namespace gudev::udev
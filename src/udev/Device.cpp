@@ -0,0 +1,435 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <cctype>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+
+#include <strings.h>
+
+#include "gudevxx/udev/Device.hpp"
+
+
+namespace gudev::udev {
+
+    namespace {
+
+        std::optional<std::string>
+        opt_str(const char* s)
+        {
+            if (s)
+                return s;
+            return {};
+        }
+
+
+        template<typename T>
+        std::vector<T>
+        list_names(udev_list_entry* first)
+        {
+            std::vector<T> result;
+            udev_list_entry* e;
+            udev_list_entry_foreach(e, first)
+                result.emplace_back(udev_list_entry_get_name(e));
+            return result;
+        }
+
+
+        // The conversions below follow the semantics of libgudev.
+
+        int
+        to_int(const char* s)
+        {
+            return s ? static_cast<int>(std::strtol(s, nullptr, 0)) : 0;
+        }
+
+
+        std::uint64_t
+        to_uint64(const char* s)
+        {
+            return s ? std::strtoull(s, nullptr, 0) : 0;
+        }
+
+
+        // libgudev uses g_ascii_strtod(), so the decimal point is '.' in every locale.
+        double
+        to_double(const char* s)
+        {
+            if (!s)
+                return 0.0;
+            std::string_view v = s;
+            while (!v.empty() && std::isspace(static_cast<unsigned char>(v.front())))
+                v.remove_prefix(1);
+            // from_chars() doesn't take a leading '+'.
+            if (v.starts_with('+'))
+                v.remove_prefix(1);
+            double result = 0.0;
+            std::from_chars(v.data(), v.data() + v.size(), result);
+            return result;
+        }
+
+
+        bool
+        to_bool(const char* s)
+        {
+            if (!s)
+                return false;
+            std::string_view v = s;
+            while (!v.empty() && (v.back() == '\n' || v.back() == ' '))
+                v.remove_suffix(1);
+            return v == "1" || (v.size() == 4 && strncasecmp(v.data(), "true", 4) == 0);
+        }
+
+    } // namespace
+
+
+    Device::Device(std::nullptr_t)
+        noexcept
+    {}
+
+
+    std::optional<std::string>
+    Device::subsystem()
+        const
+    {
+        return opt_str(udev_device_get_subsystem(raw));
+    }
+
+
+    std::optional<std::string>
+    Device::devtype()
+        const
+    {
+        return opt_str(udev_device_get_devtype(raw));
+    }
+
+
+    std::optional<std::string>
+    Device::name()
+        const
+    {
+        return opt_str(udev_device_get_sysname(raw));
+    }
+
+
+    std::optional<std::string>
+    Device::number()
+        const
+    {
+        return opt_str(udev_device_get_sysnum(raw));
+    }
+
+
+    std::optional<std::filesystem::path>
+    Device::sysfs()
+        const
+    {
+        if (auto p = udev_device_get_syspath(raw))
+            return p;
+        return {};
+    }
+
+
+    std::optional<std::string>
+    Device::driver()
+        const
+    {
+        return opt_str(udev_device_get_driver(raw));
+    }
+
+
+    std::optional<std::string>
+    Device::action()
+        const
+    {
+        return opt_str(udev_device_get_action(raw));
+    }
+
+
+    std::optional<std::uint64_t>
+    Device::seqnum()
+        const
+    {
+        auto s = udev_device_get_seqnum(raw);
+        if (s)
+            return s;
+        return {};
+    }
+
+
+    Device::Type
+    Device::type()
+        const
+    {
+        if (!udev_device_get_devnum(raw))
+            return Type::no_device;
+        const char* sub = udev_device_get_subsystem(raw);
+        if (sub && std::strcmp(sub, "block") == 0)
+            return Type::block_device;
+        return Type::char_device;
+    }
+
+
+    std::optional<std::uint64_t>
+    Device::device_number()
+        const
+    {
+        auto n = udev_device_get_devnum(raw);
+        if (n)
+            return n;
+        return {};
+    }
+
+
+    std::optional<std::filesystem::path>
+    Device::device_file()
+        const
+    {
+        if (auto f = udev_device_get_devnode(raw))
+            return f;
+        return {};
+    }
+
+
+    std::vector<std::filesystem::path>
+    Device::device_symlinks()
+        const
+    {
+        return list_names<std::filesystem::path>(udev_device_get_devlinks_list_entry(raw));
+    }
+
+
+    std::optional<Device>
+    Device::parent()
+        const
+    {
+        // Note: the parent is owned by the child, so we need a new reference.
+        auto p = udev_device_get_parent(raw);
+        if (!p)
+            return {};
+        return make_alias(p);
+    }
+
+
+    std::optional<Device>
+    Device::parent(zstring_view subsystem)
+        const
+    {
+        auto p = udev_device_get_parent_with_subsystem_devtype(raw,
+                                                               subsystem.c_str(),
+                                                               nullptr);
+        if (!p)
+            return {};
+        return make_alias(p);
+    }
+
+
+    std::optional<Device>
+    Device::parent(zstring_view subsystem,
+                   zstring_view devtype)
+        const
+    {
+        auto p = udev_device_get_parent_with_subsystem_devtype(raw,
+                                                               subsystem.c_str(),
+                                                               devtype.c_str());
+        if (!p)
+            return {};
+        return make_alias(p);
+    }
+
+
+    std::vector<std::string>
+    Device::tags()
+        const
+    {
+        return list_names<std::string>(udev_device_get_tags_list_entry(raw));
+    }
+
+
+    bool
+    Device::has_tag(zstring_view tag)
+        const
+    {
+        return udev_device_has_tag(raw, tag.c_str()) > 0;
+    }
+
+
+    bool
+    Device::is_initialized()
+        const
+    {
+        return udev_device_get_is_initialized(raw) > 0;
+    }
+
+
+    std::chrono::microseconds
+    Device::usec_since_initialized()
+        const
+    {
+        auto u = udev_device_get_usec_since_initialized(raw);
+        return std::chrono::microseconds(u);
+    }
+
+
+    std::vector<std::string>
+    Device::property_keys()
+        const
+    {
+        return list_names<std::string>(udev_device_get_properties_list_entry(raw));
+    }
+
+
+    bool
+    Device::has_property(zstring_view key)
+        const
+    {
+        return udev_device_get_property_value(raw, key.c_str()) != nullptr;
+    }
+
+
+    std::optional<std::string>
+    Device::property(zstring_view key)
+        const
+    {
+        return opt_str(udev_device_get_property_value(raw, key.c_str()));
+    }
+
+
+    template<>
+    int
+    Device::property_as<int>(zstring_view key)
+        const
+    {
+        return to_int(udev_device_get_property_value(raw, key.c_str()));
+    }
+
+
+    template<>
+    std::uint64_t
+    Device::property_as<std::uint64_t>(zstring_view key)
+        const
+    {
+        return to_uint64(udev_device_get_property_value(raw, key.c_str()));
+    }
+
+
+    template<>
+    double
+    Device::property_as<double>(zstring_view key)
+        const
+    {
+        return to_double(udev_device_get_property_value(raw, key.c_str()));
+    }
+
+
+    template<>
+    bool
+    Device::property_as<bool>(zstring_view key)
+        const
+    {
+        return to_bool(udev_device_get_property_value(raw, key.c_str()));
+    }
+
+
+    template<>
+    std::string
+    Device::property_as<std::string>(zstring_view key)
+        const
+    {
+        return property(key).value_or("");
+    }
+
+
+    std::vector<std::string>
+    Device::sysfs_attr_keys()
+        const
+    {
+        return list_names<std::string>(udev_device_get_sysattr_list_entry(raw));
+    }
+
+
+    bool
+    Device::has_sysfs_attr(zstring_view key)
+        const
+    {
+        return udev_device_get_sysattr_value(raw, key.c_str()) != nullptr;
+    }
+
+
+    std::optional<std::string>
+    Device::sysfs_attr(zstring_view key)
+        const
+    {
+        return opt_str(udev_device_get_sysattr_value(raw, key.c_str()));
+    }
+
+
+    template<>
+    int
+    Device::sysfs_attr_as<int>(zstring_view key)
+        const
+    {
+        return to_int(udev_device_get_sysattr_value(raw, key.c_str()));
+    }
+
+
+    template<>
+    std::uint64_t
+    Device::sysfs_attr_as<std::uint64_t>(zstring_view key)
+        const
+    {
+        return to_uint64(udev_device_get_sysattr_value(raw, key.c_str()));
+    }
+
+
+    template<>
+    double
+    Device::sysfs_attr_as<double>(zstring_view key)
+        const
+    {
+        return to_double(udev_device_get_sysattr_value(raw, key.c_str()));
+    }
+
+
+    template<>
+    bool
+    Device::sysfs_attr_as<bool>(zstring_view key)
+        const
+    {
+        return to_bool(udev_device_get_sysattr_value(raw, key.c_str()));
+    }
+
+
+    template<>
+    std::string
+    Device::sysfs_attr_as<std::string>(zstring_view key)
+        const
+    {
+        return sysfs_attr(key).value_or("");
+    }
+
+
+    Device
+    Device::make_owner(udev_device* dev)
+        noexcept
+    {
+        return Device{dev};
+    }
+
+
+    Device
+    Device::make_alias(udev_device* dev)
+        noexcept
+    {
+        Device result;
+        result.alias(dev);
+        return result;
+    }
+
+} // namespace gudev::udev
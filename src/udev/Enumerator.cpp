@@ -0,0 +1,139 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <stdexcept>
+
+#include "gudevxx/udev/Enumerator.hpp"
+
+
+namespace gudev::udev {
+
+    Enumerator::Enumerator(std::nullptr_t)
+        noexcept
+    {}
+
+
+    Enumerator::Enumerator(Client& client)
+    {
+        create(client);
+    }
+
+
+    void
+    Enumerator::create(Client& client)
+    {
+        auto ptr = udev_enumerate_new(client.data());
+        if (!ptr)
+            throw std::runtime_error{"Could not create new udev_enumerate"};
+        destroy();
+        acquire(ptr);
+    }
+
+
+    Enumerator&
+    Enumerator::match_subsystem(zstring_view subsystem)
+    {
+        udev_enumerate_add_match_subsystem(raw, subsystem.c_str());
+        return *this;
+    }
+
+
+    Enumerator&
+    Enumerator::nomatch_subsystem(zstring_view subsystem)
+    {
+        udev_enumerate_add_nomatch_subsystem(raw, subsystem.c_str());
+        return *this;
+    }
+
+
+    Enumerator&
+    Enumerator::match_sysfs_attr(zstring_view key,
+                                 zstring_view val)
+    {
+        udev_enumerate_add_match_sysattr(raw, key.c_str(), val.c_str());
+        return *this;
+    }
+
+
+    Enumerator&
+    Enumerator::nomatch_sysfs_attr(zstring_view key,
+                                   zstring_view val)
+    {
+        udev_enumerate_add_nomatch_sysattr(raw, key.c_str(), val.c_str());
+        return *this;
+    }
+
+
+    Enumerator&
+    Enumerator::match_property(zstring_view key,
+                               zstring_view val)
+    {
+        udev_enumerate_add_match_property(raw, key.c_str(), val.c_str());
+        return *this;
+    }
+
+
+    Enumerator&
+    Enumerator::match_name(zstring_view name)
+    {
+        udev_enumerate_add_match_sysname(raw, name.c_str());
+        return *this;
+    }
+
+
+    Enumerator&
+    Enumerator::match_tag(zstring_view tag)
+    {
+        udev_enumerate_add_match_tag(raw, tag.c_str());
+        return *this;
+    }
+
+
+    Enumerator&
+    Enumerator::match_initialized()
+    {
+        udev_enumerate_add_match_is_initialized(raw);
+        return *this;
+    }
+
+
+    Enumerator&
+    Enumerator::add_sysfs_path(const std::filesystem::path& sysfs_path)
+    {
+        udev_enumerate_add_syspath(raw, sysfs_path.c_str());
+        return *this;
+    }
+
+
+    std::vector<Device>
+    Enumerator::execute()
+    {
+        udev_enumerate_scan_devices(raw);
+        std::vector<Device> result;
+        udev_list_entry* e;
+        udev_list_entry_foreach(e, udev_enumerate_get_list_entry(raw)) {
+            auto d = udev_device_new_from_syspath(udev_enumerate_get_udev(raw),
+                                                  udev_list_entry_get_name(e));
+            if (d)
+                result.push_back(Device::make_owner(d));
+        }
+        return result;
+    }
+
+
+    std::vector<std::filesystem::path>
+    Enumerator::execute_paths()
+    {
+        udev_enumerate_scan_devices(raw);
+        std::vector<std::filesystem::path> result;
+        udev_list_entry* e;
+        udev_list_entry_foreach(e, udev_enumerate_get_list_entry(raw))
+            result.emplace_back(udev_list_entry_get_name(e));
+        return result;
+    }
+
+} // namespace gudev::udev
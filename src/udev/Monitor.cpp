@@ -0,0 +1,79 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <stdexcept>
+#include <string>
+
+#include "gudevxx/udev/Monitor.hpp"
+
+
+namespace gudev::udev {
+
+    Monitor::Monitor(std::nullptr_t)
+        noexcept
+    {}
+
+
+    Monitor::Monitor(Client& client,
+                     std::span<const zstring_view> subsystems,
+                     std::span<const zstring_view> tags)
+    {
+        create(client, subsystems, tags);
+    }
+
+
+    void
+    Monitor::create(Client& client,
+                    std::span<const zstring_view> subsystems,
+                    std::span<const zstring_view> tags)
+    {
+        auto ptr = udev_monitor_new_from_netlink(client.data(), "udev");
+        if (!ptr)
+            throw std::runtime_error{"Could not create new udev_monitor"};
+        destroy();
+        acquire(ptr);
+
+        // Same "subsystem/devtype" syntax as g_udev_client_new().
+        for (auto& filter : subsystems) {
+            std::string_view f = filter;
+            auto slash = f.find('/');
+            if (slash == std::string_view::npos)
+                udev_monitor_filter_add_match_subsystem_devtype(raw, filter.c_str(), nullptr);
+            else {
+                std::string subsystem{f.substr(0, slash)};
+                udev_monitor_filter_add_match_subsystem_devtype(raw,
+                                                                subsystem.c_str(),
+                                                                filter.c_str() + slash + 1);
+            }
+        }
+
+        for (auto& tag : tags)
+            udev_monitor_filter_add_match_tag(raw, tag.c_str());
+
+        if (udev_monitor_enable_receiving(raw) < 0)
+            throw std::runtime_error{"Could not enable receiving on udev_monitor"};
+    }
+
+
+    int
+    Monitor::fd()
+        const noexcept
+    {
+        return udev_monitor_get_fd(raw);
+    }
+
+
+    std::optional<Device>
+    Monitor::receive()
+    {
+        auto d = udev_monitor_receive_device(raw);
+        if (d)
+            return Device::make_owner(d);
+        return {};
+    }
+
+} // namespace gudev::udev
@@ -9,6 +9,8 @@
 #define LIBGUDEVXX_UTILS_HPP
 
 #include <cstddef>
+#include <memory_resource>
+#include <string>
 #include <vector>
 
 #include <glib.h>
@@ -36,17 +38,69 @@ namespace gudev::utils {
     }
 
 
+    template<typename T>
+    std::pmr::vector<T>
+    gobj_list_to_vector(GList* list,
+                        std::pmr::memory_resource* mr)
+    {
+        try  {
+            std::pmr::vector<T> result{mr};
+            result.reserve(g_list_length(list));
+            for (GList* i = list; i; i = i->next)
+                result.push_back(reinterpret_cast<T>(i->data));
+            g_list_free(list);
+            return result;
+        }
+        catch (...) {
+            for (GList* i = list; i; i = i->next)
+                g_object_unref(i->data);
+            g_list_free(list);
+            throw;
+        }
+    }
+
+
+    inline
+    std::size_t
+    strv_size(const char* const strv[])
+        noexcept
+    {
+        std::size_t n = 0;
+        if (strv)
+            while (strv[n])
+                ++n;
+        return n;
+    }
+
+
     template<typename T = std::string>
     inline
     std::vector<T>
     strv_to_vector(const char* const strv[])
     {
         std::vector<T> result;
-        for (std::size_t i = 0; strv[i]; ++i)
+        const std::size_t n = strv_size(strv);
+        result.reserve(n);
+        for (std::size_t i = 0; i < n; ++i)
             result.push_back(strv[i]);
         return result;
     }
 
+
+    template<typename T = std::pmr::string>
+    inline
+    std::pmr::vector<T>
+    strv_to_vector(const char* const strv[],
+                   std::pmr::memory_resource* mr)
+    {
+        std::pmr::vector<T> result{mr};
+        const std::size_t n = strv_size(strv);
+        result.reserve(n);
+        for (std::size_t i = 0; i < n; ++i)
+            result.emplace_back(strv[i]);
+        return result;
+    }
+
 } // namespace gudev::utils
 
 #endif
@@ -0,0 +1,45 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef LIBGUDEVXX_TESTS_CHECK_HPP
+#define LIBGUDEVXX_TESTS_CHECK_HPP
+
+#include <cstdio>
+#include <cstdlib>
+
+
+namespace check {
+
+    inline int failures = 0;
+
+    /// Exit status that makes automake report the test as skipped.
+    constexpr int skip = 77;
+
+
+    inline
+    int
+    result()
+    {
+        if (failures)
+            std::fprintf(stderr, "%d check(s) failed\n", failures);
+        return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+    }
+
+} // namespace check
+
+
+#define CHECK(expr)                                                     \
+    do {                                                                \
+        if (!(expr)) {                                                  \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n",           \
+                         __FILE__, __LINE__, #expr);                    \
+            ++check::failures;                                          \
+        }                                                               \
+    } while (false)
+
+
+#endif
@@ -0,0 +1,125 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <cstdlib>
+#include <new>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <gudevxx/Client.hpp>
+#include <gudevxx/DeviceTable.hpp>
+
+#include "check.hpp"
+
+using gudev::Client;
+using gudev::DeviceTable;
+using gudev::DeviceTableBuilder;
+
+
+namespace {
+
+    // Allocations left before operator new fails; negative means never.
+    long allocations_left = -1;
+
+
+    bool
+    consistent(const DeviceTable& table)
+    {
+        const std::size_t rows = table.num_rows;
+        bool ok = table.sysfs_path.size() == rows
+            && table.sysfs_path.offsets.size() == rows + 1
+            && table.device_file.size() == rows
+            && table.name.size() == rows
+            && table.subsystem.size() == rows
+            && table.subsystem.indices.size() == rows
+            && table.devtype.size() == rows
+            && table.driver.size() == rows
+            && table.device_number.size() == rows
+            && table.device_number.values.size() == rows;
+        for (auto& [key, column] : table.properties)
+            ok = ok && column.size() == rows && column.indices.size() == rows;
+        return ok;
+    }
+
+} // namespace
+
+
+void*
+operator new(std::size_t size)
+{
+    if (allocations_left == 0)
+        throw std::bad_alloc{};
+    if (allocations_left > 0)
+        --allocations_left;
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc{};
+}
+
+
+void
+operator delete(void* p)
+    noexcept
+{
+    std::free(p);
+}
+
+
+void
+operator delete(void* p,
+                std::size_t)
+    noexcept
+{
+    std::free(p);
+}
+
+
+int
+main()
+{
+    Client client;
+    // "lo" has INTERFACE, "null" doesn't.
+    auto lo = client.get_sysfs("/sys/class/net/lo");
+    auto null = client.get_sysfs("/sys/class/mem/null");
+    if (!lo || !null)
+        return check::skip;
+
+    const std::vector<std::string> keys{"INTERFACE", "MAJOR"};
+
+    for (bool fixed : {false, true}) {
+        // Fail the second append at every allocation in turn, until it succeeds.
+        for (long n = 0; ; ++n) {
+            DeviceTableBuilder builder = fixed ? DeviceTableBuilder{keys} : DeviceTableBuilder{};
+            builder.append(*lo);
+
+            bool failed = false;
+            allocations_left = n;
+            try {
+                builder.append(*lo);
+            }
+            catch (std::bad_alloc&) {
+                failed = true;
+            }
+            allocations_left = -1;
+            CHECK(builder.size() == (failed ? 1u : 2u));
+
+            builder.append(*null);
+            DeviceTable table = builder.finish();
+            CHECK(consistent(table));
+            if (auto column = table.property("INTERFACE")) {
+                CHECK((*column)[0] == "lo");
+                CHECK(!(*column)[table.num_rows - 1]);
+            }
+
+            if (!failed)
+                break;
+        }
+    }
+
+    return check::result();
+}
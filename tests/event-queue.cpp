@@ -0,0 +1,78 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <string>
+#include <vector>
+
+#include <gudevxx/Client.hpp>
+#include <gudevxx/EventQueue.hpp>
+
+#include "check.hpp"
+
+using gudev::EventQueue;
+
+
+int
+main()
+{
+    gudev::Client client;
+    auto null = client.get_sysfs("/sys/devices/virtual/mem/null");
+    auto zero = client.get_sysfs("/sys/devices/virtual/mem/zero");
+    if (!null || !zero)
+        return check::skip;
+
+    std::vector<std::string> seen;
+    EventQueue::handler_type record = [&seen](const std::string& action, gudev::Device&)
+    {
+        seen.push_back(action);
+    };
+
+    {
+        // push, drain, push for the same path must not reuse the drained slot.
+        EventQueue q{EventQueue::Options{.policy = EventQueue::Policy::coalesce}};
+        q.push("add", *null, record);
+        CHECK(q.drain(record) == 1);
+        q.push("change", *null, record);
+        q.push("change", *null, record);
+        CHECK(q.size() == 1);
+        CHECK(q.counters().coalesced == 1);
+        seen.clear();
+        CHECK(q.drain(record) == 1);
+        CHECK(seen == std::vector<std::string>{"change"});
+        q.push("change", *null, record);
+        CHECK(q.size() == 1);
+    }
+
+    {
+        EventQueue q{EventQueue::Options{.policy = EventQueue::Policy::coalesce}};
+        q.push("add", *null, record);
+        q.push("change", *null, record);
+        q.push("add", *zero, record);
+        q.push("remove", *zero, record);
+        CHECK(q.size() == 1);
+        seen.clear();
+        q.drain(record);
+        CHECK(seen == std::vector<std::string>{"add"});
+    }
+
+    {
+        // The block policy drains inline, even with an oversized low watermark.
+        EventQueue q{EventQueue::Options{
+                .capacity = 2,
+                .policy = EventQueue::Policy::block,
+                .low_watermark = 10,
+            }};
+        seen.clear();
+        for (int i = 0; i < 5; ++i)
+            q.push("change", *null, record);
+        CHECK(q.size() <= 2);
+        CHECK(seen.size() + q.size() == 5);
+        CHECK(q.counters().blocked > 0);
+    }
+
+    return check::result();
+}
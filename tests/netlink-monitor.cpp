@@ -0,0 +1,156 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <endian.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <glib.h>
+
+#include <gudevxx/NetlinkMonitor.hpp>
+
+#include "check.hpp"
+
+using gudev::NetlinkMonitor;
+using gudev::Uevent;
+
+using namespace std::literals;
+
+
+namespace {
+
+    struct Received {
+        std::string action;
+        std::string devpath;
+        std::string subsystem;
+        std::uint64_t seqnum;
+        bool from_kernel;
+        std::string id_bus;
+    };
+
+
+    // "action@devpath" followed by the properties, as sent by the kernel.
+    std::string
+    kernel_message(std::string_view action,
+                   std::string_view devpath,
+                   std::string_view subsystem,
+                   unsigned seqnum)
+    {
+        std::string msg;
+        msg.append(action).append("@").append(devpath).append(1, '\0');
+        msg.append("ACTION=").append(action).append(1, '\0');
+        msg.append("DEVPATH=").append(devpath).append(1, '\0');
+        msg.append("SUBSYSTEM=").append(subsystem).append(1, '\0');
+        msg.append("SEQNUM=").append(std::to_string(seqnum)).append(1, '\0');
+        return msg;
+    }
+
+
+    // Same layout as libudev's monitor_netlink_header, without the filter hashes.
+    std::string
+    udev_message(std::string_view properties)
+    {
+        std::uint32_t header[10] = {};
+        std::memcpy(header, "libudev", 8);
+        header[2] = htobe32(0xfeedcafe);
+        header[3] = sizeof header;
+        header[4] = sizeof header;
+        header[5] = properties.size();
+        std::string msg{reinterpret_cast<const char*>(header), sizeof header};
+        msg.append(properties);
+        return msg;
+    }
+
+
+    void
+    send_message(int fd,
+                 const std::string& msg)
+    {
+        CHECK(send(fd, msg.data(), msg.size(), 0) == ssize_t(msg.size()));
+    }
+
+} // namespace
+
+
+int
+main()
+{
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0, fds) < 0)
+        return check::skip;
+    const int peer = fds[1];
+
+    auto mon = NetlinkMonitor::adopt(fds[0], 2);
+    std::vector<Received> got;
+    mon.uevent_callback = [&got](const Uevent& e)
+    {
+        got.push_back({std::string{e.action},
+                       std::string{e.devpath},
+                       std::string{e.subsystem},
+                       e.seqnum,
+                       e.from_kernel,
+                       std::string{e.property("ID_BUS").value_or("")}});
+    };
+
+    // Both wire formats, and a message that is neither.
+    send_message(peer, kernel_message("add", "/devices/virtual/block/loop0", "block", 7));
+    send_message(peer, udev_message("ACTION=change\0DEVPATH=/devices/pci0000:00/usb1\0"
+                                    "SUBSYSTEM=usb\0SEQNUM=8\0ID_BUS=usb\0"sv));
+    CHECK(mon.receive() == 2);
+    send_message(peer, "garbage"s);
+    CHECK(mon.receive() == 0);
+    CHECK(mon.receive() == 0);
+
+    CHECK(got.size() == 2);
+    if (got.size() == 2) {
+        CHECK(got[0].action == "add");
+        CHECK(got[0].devpath == "/devices/virtual/block/loop0");
+        CHECK(got[0].subsystem == "block");
+        CHECK(got[0].seqnum == 7);
+        CHECK(got[0].from_kernel);
+        CHECK(got[1].action == "change");
+        CHECK(got[1].subsystem == "usb");
+        CHECK(got[1].seqnum == 8);
+        CHECK(!got[1].from_kernel);
+        CHECK(got[1].id_bus == "usb");
+    }
+    auto c = mon.counters();
+    CHECK(c.messages == 3);
+    CHECK(c.batches == 2);
+    CHECK(c.rejected == 1);
+
+    // Kernel messages pass the socket filter, and are checked in full afterwards.
+    got.clear();
+    mon.set_filter(NetlinkMonitor::Filter{.subsystems = {"block"}});
+    send_message(peer, kernel_message("add", "/devices/virtual/net/lo", "net", 9));
+    send_message(peer, kernel_message("remove", "/devices/virtual/block/loop0", "block", 10));
+    CHECK(mon.receive() == 1);
+    CHECK(got.size() == 1 && got[0].seqnum == 10);
+    CHECK(mon.counters().filtered == 1);
+    mon.clear_filter();
+
+    // One batch per main loop iteration, so other sources get their turn.
+    got.clear();
+    mon.attach(1);
+    for (unsigned i = 0; i < 5; ++i)
+        send_message(peer, kernel_message("change", "/devices/virtual/block/loop0", "block", 11 + i));
+    g_main_context_iteration(nullptr, false);
+    CHECK(got.size() == 2);
+    for (int i = 0; i < 10 && got.size() < 5; ++i)
+        g_main_context_iteration(nullptr, false);
+    CHECK(got.size() == 5);
+    mon.detach();
+
+    close(peer);
+    return check::result();
+}
@@ -0,0 +1,153 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <gudevxx/MatchRules.hpp>
+#include <gudevxx/SysfsWalker.hpp>
+
+#include "check.hpp"
+
+using gudev::MatchRules;
+using gudev::SysfsWalker;
+
+namespace fs = std::filesystem;
+
+
+namespace {
+
+    void
+    write_file(const fs::path& path,
+               std::string_view content)
+    {
+        fs::create_directories(path.parent_path());
+        std::ofstream out{path, std::ios::binary};
+        out << content;
+    }
+
+
+    void
+    make_link(const fs::path& path,
+              const fs::path& target)
+    {
+        fs::create_directories(path.parent_path());
+        fs::create_directory_symlink(target, path);
+    }
+
+
+    std::vector<std::string>
+    walk(const MatchRules& rules,
+         const fs::path& root)
+    {
+        std::vector<std::string> result;
+        for (auto& p : SysfsWalker{rules, root}.paths())
+            result.push_back(p.lexically_relative(root).string());
+        std::ranges::sort(result);
+        return result;
+    }
+
+} // namespace
+
+
+int
+main()
+{
+    char dir_template[] = "/tmp/gudevxx-sysfs.XXXXXX";
+    if (!mkdtemp(dir_template))
+        return check::skip;
+    const fs::path root = dir_template;
+
+    /*
+     * mem/null and mem/zero are in class/, the PCI device in bus/, and also
+     * null in dev/char/; only platform/foo, whose subsystem is listed in
+     * neither, must come from dev/char/.
+     */
+    write_file(root / "devices/virtual/mem/null/dev", "1:3\n");
+    write_file(root / "devices/virtual/mem/zero/dev", "1:5\n");
+    write_file(root / "devices/pci0000:00/0000:00:01.0/vendor", "0x8086\n");
+    write_file(root / "devices/platform/foo/dev", "10:1\n");
+    make_link(root / "devices/virtual/mem/null/subsystem", "../../../../class/mem");
+    make_link(root / "devices/platform/foo/subsystem", "../../../bus/weird");
+
+    make_link(root / "class/mem/null", "../../devices/virtual/mem/null");
+    make_link(root / "class/mem/zero", "../../devices/virtual/mem/zero");
+    make_link(root / "bus/pci/devices/0000:00:01.0", "../../../devices/pci0000:00/0000:00:01.0");
+    make_link(root / "dev/char/1:3", "../../devices/virtual/mem/null");
+    make_link(root / "dev/char/10:1", "../../devices/platform/foo");
+
+    using list = std::vector<std::string>;
+
+    CHECK(walk(MatchRules{}, root) == (list{
+                "devices/pci0000:00/0000:00:01.0",
+                "devices/platform/foo",
+                "devices/virtual/mem/null",
+                "devices/virtual/mem/zero",
+            }));
+
+    CHECK(walk(MatchRules{}.match_subsystem("mem"), root) == (list{
+                "devices/virtual/mem/null",
+                "devices/virtual/mem/zero",
+            }));
+
+    CHECK(walk(MatchRules{}.nomatch_subsystem("mem"), root) == (list{
+                "devices/pci0000:00/0000:00:01.0",
+                "devices/platform/foo",
+            }));
+
+    CHECK(walk(MatchRules{}.match_subsystem("weird"), root) == (list{
+                "devices/platform/foo",
+            }));
+
+    CHECK(walk(MatchRules{}.match_name("z*"), root) == (list{
+                "devices/virtual/mem/zero",
+            }));
+
+    CHECK(walk(MatchRules{}.match_sysfs_attr("vendor", "0x8086"), root) == (list{
+                "devices/pci0000:00/0000:00:01.0",
+            }));
+
+    CHECK(walk(MatchRules{}.nomatch_sysfs_attr("dev", "1:*"), root) == (list{
+                "devices/pci0000:00/0000:00:01.0",
+                "devices/platform/foo",
+            }));
+
+    // Explicit paths are added if they exist, without duplicates.
+    CHECK(walk(MatchRules{}
+               .match_subsystem("mem")
+               .add_sysfs_path(root / "devices/virtual/mem/null")
+               .add_sysfs_path(root / "devices/platform/foo")
+               .add_sysfs_path(root / "devices/missing"),
+               root) == (list{
+                       "devices/platform/foo",
+                       "devices/virtual/mem/null",
+                       "devices/virtual/mem/zero",
+                   }));
+
+    SysfsWalker all{MatchRules{}, root};
+    CHECK(all.count() == 4);
+    CHECK(all.count(1) == 1);
+    CHECK(all.count(0) == 0);
+
+    bool threw = false;
+    try {
+        SysfsWalker{MatchRules{}.match_property("ID_BUS", "usb"), root};
+    }
+    catch (std::invalid_argument&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    fs::remove_all(root);
+    return check::result();
+}
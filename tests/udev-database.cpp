@@ -0,0 +1,138 @@
+/*
+ * libgudevxx - a C++ wrapper for libgudev
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <gudevxx/UdevDatabase.hpp>
+
+#include "check.hpp"
+
+using gudev::UdevDatabase;
+
+using namespace std::literals;
+
+
+namespace {
+
+    void
+    write_file(const std::filesystem::path& path,
+               std::string_view content)
+    {
+        std::ofstream out{path, std::ios::binary};
+        out << content;
+    }
+
+} // namespace
+
+
+int
+main()
+{
+    char dir_template[] = "/tmp/gudevxx-udev-db.XXXXXX";
+    if (!mkdtemp(dir_template))
+        return check::skip;
+    const std::filesystem::path dir = dir_template;
+
+    write_file(dir / "b8:0",
+               "S:disk/by-id/ata-foo\n"
+               "S:disk/by-path/pci-0\n"
+               "L:10\n"
+               "I:123456\n"
+               "E:ID_SERIAL=foo\n"
+               "E:DEVTYPE=disk\n"
+               "E:ID_BUS=ata\n"
+               "G:systemd\n"
+               "G:seat\n"
+               "Q:systemd\n"
+               "V:1\n");
+    write_file(dir / "n3",
+               "I:99\n"
+               "E:ID_NET_NAME=enp0s3\n"
+               "E:INTERFACE=eth0\n"
+               "G:systemd\n");
+    // Malformed lines are skipped; the last line has no newline.
+    write_file(dir / "+pci:0000:00:14.0",
+               "X\n"
+               "E:NOEQUALS\n"
+               "I:notanumber\n"
+               "\n"
+               "E:DRIVER=xhci_hcd");
+    // udev's temporary files are ignored.
+    write_file(dir / ".#b8:16abcdef", "E:ID_SERIAL=partial\n");
+
+    UdevDatabase db{dir};
+    db.load();
+
+    CHECK(db.size() == 3);
+    auto records = db.records();
+    CHECK(records.size() == 3
+          && records[0].id == "+pci:0000:00:14.0"
+          && records[1].id == "b8:0"
+          && records[2].id == "n3");
+
+    if (auto disk = db.find("b8:0")) {
+        CHECK(disk->properties.size() == 3);
+        CHECK(disk->properties.size() == 3
+              && disk->properties[0].key == "DEVTYPE"
+              && disk->properties[1].key == "ID_BUS"
+              && disk->properties[2].key == "ID_SERIAL");
+        CHECK(disk->property("ID_SERIAL") == "foo"sv);
+        CHECK(!disk->property("ID_MODEL"));
+        CHECK(disk->tags.size() == 2 && disk->tags[0] == "systemd" && disk->tags[1] == "seat");
+        CHECK(disk->has_tag("seat"));
+        CHECK(!disk->has_tag("uaccess"));
+        CHECK(disk->current_tags.size() == 1 && disk->current_tags[0] == "systemd");
+        CHECK(disk->symlinks.size() == 2 && disk->symlinks[0] == "disk/by-id/ata-foo");
+        CHECK(disk->devlink_priority == 10);
+        CHECK(disk->usec_initialized == 123456u);
+    } else
+        CHECK(!"b8:0 not found");
+
+    if (auto pci = db.find("+pci:0000:00:14.0")) {
+        CHECK(pci->properties.size() == 1);
+        CHECK(pci->property("DRIVER") == "xhci_hcd"sv);
+        CHECK(!pci->usec_initialized);
+        CHECK(pci->devlink_priority == 0);
+        CHECK(pci->tags.empty() && pci->current_tags.empty() && pci->symlinks.empty());
+    } else
+        CHECK(!"+pci:0000:00:14.0 not found");
+
+    CHECK(!db.find("b8:16"));
+
+    auto matches = db.find_property("ID_NET_NAME");
+    CHECK(matches.size() == 1 && matches[0].id == "n3" && matches[0].value == "enp0s3");
+
+    const std::string_view ids[] = {"n3", "c1:3", "b8:0"};
+    auto values = db.property(ids, "INTERFACE");
+    CHECK(values == (std::vector<std::optional<std::string_view>>{"eth0"sv, std::nullopt, std::nullopt}));
+
+    // A reload sees removed records.
+    std::filesystem::remove(dir / "n3");
+    db.load();
+    CHECK(db.size() == 2);
+    CHECK(!db.find("n3"));
+
+    std::filesystem::remove_all(dir);
+
+    bool threw = false;
+    try {
+        db.load();
+    }
+    catch (std::system_error&) {
+        threw = true;
+    }
+    CHECK(threw);
+
+    return check::result();
+}
@@ -0,0 +1,31 @@
+#!/bin/sh
+# Compare gudevxx-dump against udevadm.
+# Usage: tools/bench-dump.sh [path/to/gudevxx-dump] [runs]
+
+DUMP=${1:-./gudevxx-dump}
+RUNS=${2:-10}
+
+if command -v hyperfine >/dev/null 2>&1 ; then
+    exec hyperfine --warmup 2 --runs "$RUNS" \
+         'udevadm info --export-db' \
+         "$DUMP --format=db" \
+         "$DUMP --format=db --threads=1" \
+         "$DUMP --format=json"
+fi
+
+run() {
+    printf '%-40s' "$*"
+    start=$(date +%s%N)
+    i=0
+    while [ $i -lt "$RUNS" ] ; do
+        "$@" >/dev/null
+        i=$((i + 1))
+    done
+    end=$(date +%s%N)
+    echo "$(( (end - start) / RUNS / 1000000 )) ms"
+}
+
+run udevadm info --export-db
+run "$DUMP" --format=db
+run "$DUMP" --format=db --threads=1
+run "$DUMP" --format=json
@@ -0,0 +1,357 @@
+/*
+ * gudevxx-dump - dump the udev device database
+ *
+ * Copyright (C) 2025  Daniel K. O.
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <future>
+#include <iostream>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <getopt.h>
+#include <sys/sysmacros.h>
+#include <unistd.h>
+
+#include <gudevxx/Device.hpp>
+#include <gudevxx/JsonWriter.hpp>
+#include <gudevxx/MatchRules.hpp>
+#include <gudevxx/ParallelEnumerator.hpp>
+
+
+using std::string;
+using std::string_view;
+
+using gudev::Device;
+using gudev::JsonWriter;
+
+using namespace std::literals;
+
+
+namespace {
+
+    enum class Format {
+        db,
+        json
+    };
+
+
+    struct Options {
+        Format format = Format::db;
+        bool sysfs_attrs = false;
+        unsigned threads = 0;
+        std::vector<string> subsystems;
+    };
+
+
+    // Output is written in chunks of at least this size.
+    constexpr std::size_t chunk_size = 1 << 20;
+
+    // Devices formatted per work item; small, so output starts early.
+    constexpr std::size_t slice_size = 256;
+
+
+    void
+    write_all(int fd,
+              string_view data)
+    {
+        while (!data.empty()) {
+            ssize_t n = ::write(fd, data.data(), data.size());
+            if (n < 0) {
+                if (errno == EINTR)
+                    continue;
+                throw std::system_error{errno, std::system_category(), "write()"};
+            }
+            data.remove_prefix(n);
+        }
+    }
+
+
+    string_view
+    strip_dev(const char* path)
+    {
+        string_view p = path;
+        if (p.starts_with("/dev/"))
+            p.remove_prefix(5);
+        return p;
+    }
+
+
+    void
+    append_line(string& out,
+                char tag,
+                string_view value)
+    {
+        out += tag;
+        out += ": ";
+        out += value;
+        out += '\n';
+    }
+
+
+    void
+    append_number(string& out,
+                  unsigned value)
+    {
+        char digits[12];
+        auto [end, ec] = std::to_chars(digits, digits + sizeof digits, value);
+        out.append(digits, end);
+    }
+
+
+    /*
+     * A subset of the "udevadm info --export-db" record: the P, M, R, U, T, D,
+     * N, S, V and E lines, in udevadm's order. libgudev doesn't expose the
+     * device id (J), driver subsystem (B), ifindex (I), link priority (L) or
+     * diskseq (Q) fields; tags show up as the TAGS and CURRENT_TAGS properties,
+     * like udevadm prints them.
+     */
+    void
+    format_db(string& out,
+              const Device& device,
+              bool sysfs_attrs)
+    {
+        GUdevDevice* dev = device.data();
+
+        if (const char* sysfs = g_udev_device_get_sysfs_path(dev)) {
+            string_view path = sysfs;
+            if (path.starts_with("/sys"))
+                path.remove_prefix(4);
+            append_line(out, 'P', path);
+        }
+        if (const char* name = g_udev_device_get_name(dev))
+            append_line(out, 'M', name);
+        if (const char* number = g_udev_device_get_number(dev))
+            append_line(out, 'R', number);
+        if (const char* subsystem = g_udev_device_get_subsystem(dev))
+            append_line(out, 'U', subsystem);
+        if (const char* devtype = g_udev_device_get_devtype(dev))
+            append_line(out, 'T', devtype);
+
+        auto type = g_udev_device_get_device_type(dev);
+        if (type != G_UDEV_DEVICE_TYPE_NONE) {
+            auto num = g_udev_device_get_device_number(dev);
+            out += "D: ";
+            out += type == G_UDEV_DEVICE_TYPE_BLOCK ? 'b' : 'c';
+            out += ' ';
+            append_number(out, major(num));
+            out += ':';
+            append_number(out, minor(num));
+            out += '\n';
+        }
+
+        if (const char* file = g_udev_device_get_device_file(dev))
+            append_line(out, 'N', strip_dev(file));
+
+        auto links = device.device_symlinks_view();
+        for (std::size_t i = 0; i < links.size(); ++i)
+            append_line(out, 'S', strip_dev(links.c_str(i)));
+
+        if (const char* driver = g_udev_device_get_driver(dev))
+            append_line(out, 'V', driver);
+
+        auto keys = device.property_keys_view();
+        for (std::size_t i = 0; i < keys.size(); ++i) {
+            const char* val = g_udev_device_get_property(dev, keys.c_str(i));
+            out += "E: ";
+            out += keys[i];
+            out += '=';
+            out += val ? val : "";
+            out += '\n';
+        }
+
+        // Not part of udevadm's format; multi-line values are joined with "\n".
+        if (sysfs_attrs) {
+            auto attrs = device.sysfs_attr_keys_view();
+            for (std::size_t i = 0; i < attrs.size(); ++i) {
+                const char* val = g_udev_device_get_sysfs_attr(dev, attrs.c_str(i));
+                if (!val)
+                    continue;
+                out += "A: ";
+                out += attrs[i];
+                out += '=';
+                for (string_view v = val; !v.empty(); v.remove_prefix(1)) {
+                    if (v.front() == '\n') {
+                        if (v.size() > 1)
+                            out += "\\n";
+                    } else
+                        out += v.front();
+                }
+                out += '\n';
+            }
+        }
+
+        out += '\n';
+    }
+
+
+    void
+    format_range(string& out,
+                 std::span<const Device> devices,
+                 const Options& opts)
+    {
+        if (opts.format == Format::db) {
+            for (auto& d : devices)
+                format_db(out, d, opts.sysfs_attrs);
+            return;
+        }
+        JsonWriter writer{std::move(out)};
+        for (auto& d : devices) {
+            if (opts.sysfs_attrs)
+                writer.write<JsonWriter::all_fields>(d);
+            else
+                writer.write(d);
+        }
+        out = writer.release();
+    }
+
+
+    void
+    dump(const Options& opts)
+    {
+        gudev::MatchRules rules;
+        for (auto& s : opts.subsystems)
+            rules.match_subsystem(s);
+        gudev::ParallelEnumerator etor{rules, opts.threads};
+        auto devices = etor.execute();
+
+        unsigned n = opts.threads ? opts.threads : std::max(1u, std::thread::hardware_concurrency());
+        const std::size_t num_slices = std::max<std::size_t>(1, (devices.size() + slice_size - 1) / slice_size);
+        n = std::clamp<unsigned>(n, 1, num_slices);
+
+        /*
+         * Threads take slices in order, each formatted into its own buffer;
+         * each buffer is written as soon as it and all before it are done.
+         */
+        std::vector<string> buffers(num_slices);
+        std::vector<std::promise<void>> formatted(num_slices);
+        std::vector<std::future<void>> ready;
+        ready.reserve(num_slices);
+        for (auto& f : formatted)
+            ready.push_back(f.get_future());
+        std::atomic_size_t next_slice = 0;
+
+        std::vector<std::jthread> threads;
+        for (unsigned t = 0; t < n; ++t)
+            threads.emplace_back([&]
+            {
+                for (std::size_t s; (s = next_slice.fetch_add(1)) < num_slices;) {
+                    try {
+                        std::size_t first = s * slice_size;
+                        std::size_t last = std::min(devices.size(), first + slice_size);
+                        format_range(buffers[s],
+                                     std::span{devices}.subspan(first, last - first),
+                                     opts);
+                        formatted[s].set_value();
+                    }
+                    catch (...) {
+                        formatted[s].set_exception(std::current_exception());
+                    }
+                }
+            });
+
+        try {
+            // Coalesce small buffers, so each write() is at least one chunk.
+            string pending;
+            for (std::size_t s = 0; s < num_slices; ++s) {
+                ready[s].get();
+                auto& b = buffers[s];
+                if (pending.empty())
+                    pending.swap(b);
+                else
+                    pending += b;
+                string{}.swap(b);
+                if (pending.size() >= chunk_size) {
+                    write_all(STDOUT_FILENO, pending);
+                    pending.clear();
+                }
+            }
+            write_all(STDOUT_FILENO, pending);
+        }
+        catch (...) {
+            // Stop handing out slices; the threads are joined on the way out.
+            next_slice = num_slices;
+            throw;
+        }
+    }
+
+
+    void
+    usage(const char* prog)
+    {
+        std::cout << "Usage: " << prog << " [OPTION]...\n"
+            "Dump the udev device database.\n"
+            "\n"
+            "  -f, --format=FORMAT    'db' (like udevadm info --export-db, default) or 'json' (NDJSON)\n"
+            "  -a, --sysfs-attrs      include sysfs attributes\n"
+            "  -s, --subsystem=NAME   only dump this subsystem (can be repeated)\n"
+            "  -j, --threads=N        number of threads (default: one per core)\n"
+            "  -h, --help             show this help\n";
+    }
+
+} // namespace
+
+
+int
+main(int argc,
+     char* argv[])
+try {
+    static const option long_options[] = {
+        {"format",      required_argument, nullptr, 'f'},
+        {"sysfs-attrs", no_argument,       nullptr, 'a'},
+        {"subsystem",   required_argument, nullptr, 's'},
+        {"threads",     required_argument, nullptr, 'j'},
+        {"help",        no_argument,       nullptr, 'h'},
+        {nullptr,       0,                 nullptr, 0}
+    };
+
+    Options opts;
+    int c;
+    while ((c = getopt_long(argc, argv, "f:as:j:h", long_options, nullptr)) != -1) {
+        switch (c) {
+            case 'f':
+                if (optarg == "db"sv)
+                    opts.format = Format::db;
+                else if (optarg == "json"sv)
+                    opts.format = Format::json;
+                else {
+                    std::cerr << argv[0] << ": unknown format: " << optarg << "\n";
+                    return EXIT_FAILURE;
+                }
+                break;
+            case 'a':
+                opts.sysfs_attrs = true;
+                break;
+            case 's':
+                opts.subsystems.emplace_back(optarg);
+                break;
+            case 'j':
+                opts.threads = std::strtoul(optarg, nullptr, 10);
+                break;
+            case 'h':
+                usage(argv[0]);
+                return EXIT_SUCCESS;
+            default:
+                usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    dump(opts);
+}
+catch (std::exception& e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+}